@@ -3,6 +3,7 @@
 
 #include "color.h"
 #include "tree.h"
+#include <algorithm>
 #include <iostream>
 #include <queue>
 #include <set>
@@ -32,6 +33,11 @@ public:
         }
 
         colors = vector<Color>(n + 1, Color(0));
+
+        // colors never exceed maxNodes, so both stamp arrays are indexed by node and color alike
+        visitedGeneration.assign(n + 1, 0);
+        colorGeneration.assign(n + 1, 0);
+        nearestDistanceOfColor.assign(n + 1, 0);
     }
 
     void add_edge(int from, int to) {
@@ -104,48 +110,66 @@ public:
             vector<int> thisLevel = levelOrderTraversal[level];
             for (auto candidate : thisLevel) {
                 if (colors[candidate].colorID != 0) continue;
-                // we need to color this candidate.
-                // for each node do a bfs to find if it is colorable with color = color
-                int currentlyExploringColor = 1;
-
-                set<int> colorsFoundWhileTravelling;
-
-                while (currentlyExploringColor < maxNodes) {
-                    // from color = 2 to color = MaxNodes
-                    // check if it is possible to color with this node
 
-                    // cout << "[CANDIDATE]: " << candidate << " currentlyExploringColor = " << currentlyExploringColor << endl;
+                // colors above maxReusableColorUpperBound are never reused,
+                // such a candidate is counted as a uniquely colored node.
+                int lastExploredColor = std::min(maxReusableColorUpperBound, maxNodes - 1);
+                int color = ballScanForColor(candidate, lastExploredColor);
 
-                    if (colorsFoundWhileTravelling.count(currentlyExploringColor) == 0) {
-                        colorsFoundWhileTravelling = travelForColor(Color(currentlyExploringColor), candidate);
-
-                        // cout << "calling again for currentlyExploringColor = " << currentlyExploringColor << endl;
+                if (color != 0)
+                    colors[candidate] = Color(color);
+                else if (lastExploredColor == maxReusableColorUpperBound)
+                    uniquelyUsedColors++;
+            }
+        }
 
-                        // if we don't find the current color then we color it with
-                        // currentlyExploringColor and gtfo
-                        if (colorsFoundWhileTravelling.count(currentlyExploringColor) == 0) {
-                            // cout << "*************" << endl;
-                            // for (auto i : colorsFoundWhileTravelling) { cout << i << " ";}
-                            // cout << "\n*************" << endl;
+        return uniquelyUsedColors; // colors used once
+    }
 
-                            colors[candidate] = currentlyExploringColor;
-                            break;
+    /**
+     * @brief Finds the smallest color a candidate can take using one bounded BFS.
+     *
+     * The ball around the candidate is grown one BFS layer at a time and, for every color,
+     * the nearest distance at which it appears is recorded. The candidate takes the smallest
+     * color c whose nearest distance is greater than c, so while color c is examined the ball
+     * only needs radius c. Every node of the final ball is visited exactly once.
+     *
+     * @param candidate The node to be colored.
+     * @param lastExploredColor The largest color that may be assigned.
+     * @return The smallest packable color, or 0 if no color in [1, lastExploredColor] fits.
+     */
+    int ballScanForColor(int candidate, int lastExploredColor) {
+        beginScan();
+
+        frontier.assign(1, candidate);
+        visitedGeneration[candidate] = generation;
+        recordColor(colors[candidate].colorID, 0);
+
+        int radius = 0;
+        for (int color = 1; color <= lastExploredColor; color++) {
+            // grow the ball until it holds every node within distance color
+            while (radius < color and not frontier.empty()) {
+                radius++;
+                nextFrontier.clear();
+
+                for (int node : frontier) {
+                    for (auto nbr : adj_list[node]) {
+                        if (visitedGeneration[nbr] != generation) {
+                            visitedGeneration[nbr] = generation;
+                            nextFrontier.push_back(nbr);
+                            recordColor(colors[nbr].colorID, radius);
                         }
                     }
-
-                    // if it is found this means we found the currentlyExploringColor
-                    // at a distance lower than the (int) currentlyExploringColor.
-                    currentlyExploringColor++;
-
-                    if (currentlyExploringColor > maxReusableColorUpperBound) {
-                        uniquelyUsedColors++;
-                        break;
-                    }
                 }
+
+                frontier.swap(nextFrontier);
             }
+
+            if (colorGeneration[color] != generation or nearestDistanceOfColor[color] > color)
+                return color;
         }
 
-        return uniquelyUsedColors; // colors used once
+        return 0;
     }
 
     set<int> travelForColor(Color clr, int node) {
@@ -185,6 +209,36 @@ public:
 
         return colorsFoundWhileVisiting;
     }
+
+private:
+    // scratch of ballScanForColor, allocated once: a node or color counts as seen in the current
+    // scan only when its stamp equals generation, so a scan costs its ball and not maxNodes
+    vector<unsigned> visitedGeneration;
+    vector<unsigned> colorGeneration;
+    vector<int> nearestDistanceOfColor;  // valid where colorGeneration is current
+    unsigned generation = 0;
+    vector<int> frontier, nextFrontier;
+
+    void beginScan() {
+        generation++;
+
+        // the stamps wrapped around, old marks could look current again
+        if (generation == 0) {
+            std::fill(visitedGeneration.begin(), visitedGeneration.end(), 0);
+            std::fill(colorGeneration.begin(), colorGeneration.end(), 0);
+            generation = 1;
+        }
+    }
+
+    /**
+     * Keeps the first, and so nearest, distance a color is found at during a scan.
+     */
+    void recordColor(int color, int distance) {
+        if (colorGeneration[color] != generation) {
+            colorGeneration[color] = generation;
+            nearestDistanceOfColor[color] = distance;
+        }
+    }
 };
 
 std::ostream &operator<<(std::ostream &stream, Graph &g) {
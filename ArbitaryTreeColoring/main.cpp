@@ -19,18 +19,19 @@
 
 #include "color.h"
 #include "graph.h"
+#include "../common/mapped_input.h"
 #include "tree.h"
 
 using namespace std;
 
 void fileIO() {
-    freopen("input.txt", "r", stdin);
+    // input.txt is mapped by MappedInput, only the output goes through a stream
     freopen("output.txt", "w", stdout);
 }
 
-void solve() {
-    int maxNodeID, edges, rootNode;
-    cin >> maxNodeID >> edges >> rootNode;
+void solve(MappedInput &input) {
+    int maxNodeID = 0, edges = 0, rootNode = 0;
+    input >> maxNodeID >> edges >> rootNode;
 
     Graph g(maxNodeID);
 
@@ -76,11 +77,12 @@ void solve() {
 
 int main() {
     fileIO();
+    MappedInput input("input.txt");
 
-    int testcases;
-    cin >> testcases;
+    int testcases = 0;
+    input >> testcases;
     
     while (testcases--) {
-        solve();
+        solve(input);
     }
 }
\ No newline at end of file
@@ -1,6 +1,8 @@
 #if !defined(TREES)
 #define TREES
 
+#include <algorithm>
+#include <array>
 #include <chrono>
 #include <iostream>
 #include <queue>
@@ -8,6 +10,8 @@
 #include <string.h>
 #include <vector>
 
+#include "../common/tree_arena.h"
+
 using namespace std;
 
 // Tree Definition
@@ -21,6 +25,13 @@ public:
         left = nullptr;
         right = nullptr;
     }
+
+    /**
+     * The child pointers, for code that walks or relinks any kind of tree node.
+     */
+    array<Tree **, 2> children() {
+        return {&left, &right};
+    }
 };
 
 namespace TreeServices {
@@ -32,12 +43,17 @@ void inOrder(Tree *root) {
     }
 }
 
-Tree *createTreeFromVector(vector<int> v) {
+/**
+ * Links the IDs of v into a complete tree in level order, its nodes are owned by arena.
+ */
+Tree *createTreeFromVector(const vector<int> &v, TreeArena<Tree> &arena) {
     if (v.size() == 0)
         return nullptr;
 
+    arena.reserve(v.size());
+
     int root = v[0];
-    Tree *treeRoot = new Tree(root);
+    Tree *treeRoot = arena.create(root);
 
     queue<Tree *> q;
     q.push(treeRoot);
@@ -47,12 +63,12 @@ Tree *createTreeFromVector(vector<int> v) {
         Tree *thisNode = q.front();
         q.pop();
 
-        thisNode->left = new Tree(v[i++]);
+        thisNode->left = arena.create(v[i++]);
         q.push(thisNode->left);
         if (i >= v.size())
             break;
 
-        thisNode->right = new Tree(v[i++]);
+        thisNode->right = arena.create(v[i++]);
         q.push(thisNode->right);
         if (i >= v.size())
             break;
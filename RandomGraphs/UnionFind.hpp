@@ -4,8 +4,10 @@
 #include <string.h>
 
 #include <climits>
+#include <cstdint>
 #include <iostream>
 #include <map>
+#include <numeric>
 #include <queue>
 #include <set>
 #include <stack>
@@ -14,10 +16,14 @@
 /**
  * @class DisjointSet
  * @brief A class that implements the Disjoint Set data structure.
+ *
+ * Elements and set sizes are stored as 32 bit integers. Find is iterative with path halving,
+ * every node on the search path is pointed to its grandparent, so long chains cannot overflow
+ * the stack and still get compressed.
  */
 class DisjointSet {
 public:
-    std::vector<int> parent, size;
+    std::vector<uint32_t> parent, size;
 
     /**
      * @brief Constructs a DisjointSet object with the specified number of elements.
@@ -25,12 +31,8 @@ public:
      */
     DisjointSet(int n) {
         parent.resize(n + 1);
-        size.resize(n + 1);
-
-        for (int i = 1; i <= n; i++) {
-            parent[i] = i;
-            size[i] = 1;
-        }
+        size.assign(n + 1, 1);
+        std::iota(parent.begin(), parent.end(), 0);
     }
 
     /**
@@ -39,9 +41,11 @@ public:
      * @return The representative element of the set that contains x.
      */
     int Find(int x) {
-        if (parent[x] == x)
-            return x;
-        return parent[x] = Find(parent[x]);
+        while (parent[x] != (uint32_t)x) {
+            parent[x] = parent[parent[x]];
+            x = parent[x];
+        }
+        return x;
     }
 
     /**
@@ -0,0 +1,46 @@
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "./benchmarks/bench_engine.h"
+#include "./benchmarks/bench_harness.h"
+#include "./benchmarks/bench_travel.h"
+
+/**
+ * Usage: bench [--repetitions R] [--sizes n1,n2,...] [--json path]
+ *
+ * Every graph is built from fixed seeds, so two runs time the same work.
+ */
+int main(int argc, char *argv[]) {
+    int repetitions = 11;
+    std::vector<int> sizes = {1000, 10000, 100000};
+    std::string jsonPath = "bench.json";
+
+    for (int i = 1; i + 1 < argc; i += 2) {
+        if (std::strcmp(argv[i], "--repetitions") == 0) {
+            repetitions = std::atoi(argv[i + 1]);
+        } else if (std::strcmp(argv[i], "--json") == 0) {
+            jsonPath = argv[i + 1];
+        } else if (std::strcmp(argv[i], "--sizes") == 0) {
+            sizes.clear();
+            for (char *size = std::strtok(argv[i + 1], ","); size != nullptr; size = std::strtok(nullptr, ","))
+                sizes.push_back(std::atoi(size));
+        }
+    }
+
+    BenchReport report(repetitions);
+    report.printHeader();
+    bench_coloringEngine(report, sizes);
+    bench_graphGeneration(report, sizes);
+    std::cout << "(checksum " << benchChecksum << ")\n\n";
+
+    bench_travelForColorPerCallCost();
+
+    if (not report.writeJSON(jsonPath)) {
+        std::cerr << "could not write " << jsonPath << "\n";
+        return 1;
+    }
+    std::cout << "results written to " << jsonPath << "\n";
+    return 0;
+}
@@ -0,0 +1,137 @@
+#if !defined(ENGINE_BENCHMARKS)
+#define ENGINE_BENCHMARKS
+
+#include <cmath>
+#include <numeric>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "../graph.hpp"
+#include "bench_harness.h"
+
+/**
+ * Graph families the engine benchmarks run on, every one a tree rooted at node 1.
+ */
+enum class BenchFamily { COMPLETE_BINARY, COMPLETE_TERNARY, RANDOM_MST, PATH, STAR };
+
+std::string benchFamilyName(BenchFamily family) {
+    switch (family) {
+        case BenchFamily::COMPLETE_BINARY: return "complete-binary";
+        case BenchFamily::COMPLETE_TERNARY: return "complete-ternary";
+        case BenchFamily::RANDOM_MST: return "random-mst";
+        case BenchFamily::PATH: return "path";
+        case BenchFamily::STAR: return "star";
+    }
+    return "unknown";
+}
+
+/**
+ * The edge probability of the G(n, p) graphs random MSTs are taken from, 2 ln n / n keeps them
+ * connected with high probability so the MST is a spanning tree.
+ */
+double benchEdgeProbability(int n) {
+    return n > 1 ? std::min(1.0, 2 * std::log(n) / n) : 1.0;
+}
+
+/**
+ * Builds a graph of the family on n nodes, the same one for the same seed.
+ */
+Graph buildBenchFamily(BenchFamily family, int n, unsigned seed) {
+    if (family == BenchFamily::RANDOM_MST) {
+        std::mt19937 generator(seed);
+        Graph G = GraphServices::generateGnP(n, benchEdgeProbability(n), generator).first;
+        return GraphServices::generateMST(G);
+    }
+
+    vector<pair<int, int>> edges;
+    edges.reserve(n > 0 ? n - 1 : 0);
+    for (int v = 2; v <= n; v++) {
+        switch (family) {
+            case BenchFamily::COMPLETE_BINARY: edges.push_back({(v - 2) / 2 + 1, v}); break;
+            case BenchFamily::COMPLETE_TERNARY: edges.push_back({(v - 2) / 3 + 1, v}); break;
+            case BenchFamily::PATH: edges.push_back({v - 1, v}); break;
+            default: edges.push_back({1, v}); break;
+        }
+    }
+
+    return Graph(n, std::move(edges));
+}
+
+/**
+ * Times the pieces of the coloring engine and a full coloring on every family and size.
+ *
+ * @param sizes Node counts to build every family at.
+ */
+void bench_coloringEngine(BenchReport &report, const std::vector<int> &sizes) {
+    const int root = 1;
+    const int radius = 4;
+    const int travelCalls = 1000;
+
+    const BenchFamily families[] = {BenchFamily::COMPLETE_BINARY, BenchFamily::COMPLETE_TERNARY,
+                                    BenchFamily::RANDOM_MST, BenchFamily::PATH, BenchFamily::STAR};
+
+    for (int n : sizes) {
+        for (BenchFamily family : families) {
+            std::string name = benchFamilyName(family);
+            Graph g = buildBenchFamily(family, n, 42);
+
+            // travelForColor reports colors, so it runs over small random ones
+            std::mt19937 generator(7);
+            std::uniform_int_distribution<int> smallColor(0, 8), node(1, n);
+            for (int v = 1; v <= n; v++) g.colors.set(v, smallColor(generator));
+
+            std::vector<int> sources(travelCalls);
+            for (auto &source : sources) source = node(generator);
+
+            report.measure(
+                "travelForColor", name, n, [] {},
+                [&] {
+                    for (int source : sources) benchChecksum += g.travelForColor(Color(radius), source).count();
+                },
+                travelCalls);
+
+            report.measure("calculateLevelOrderTraversal", name, n, [&] { g.calculateLevelOrderTraversal(root); });
+
+            // maximizeColorOne sorts the level IDs it is given, so every run starts from 0 .. levels - 1 again
+            g.calculateLevelOrderTraversal(root);
+            report.measure(
+                "maximizeColorOne", name, n,
+                [&] {
+                    g.colors.assign(n + 1, 0);
+                    g.levelOrderTraversalSorted.resize(g.levelOrderTraversal.size());
+                    std::iota(g.levelOrderTraversalSorted.begin(), g.levelOrderTraversalSorted.end(), 0);
+                },
+                [&] { g.maximizeColorOne(); });
+
+            report.measure(
+                "approximatePackingColor", name, n,
+                [&] {
+                    g.colors.assign(n + 1, 0);
+                    g.levelOrderTraversal.clear();
+                },
+                [&] { benchChecksum += g.approximatePackingColor(root); });
+        }
+    }
+}
+
+/**
+ * Times the random graph generation: G(n, p) at the edge probability of the random MSTs, and
+ * Kruskal's MST of that graph.
+ */
+void bench_graphGeneration(BenchReport &report, const std::vector<int> &sizes) {
+    for (int n : sizes) {
+        double p = benchEdgeProbability(n);
+        std::mt19937 generator;
+        Graph G(0);
+
+        report.measure(
+            "generateGnP", "gnp", n, [&] { generator.seed(42); },
+            [&] { G = GraphServices::generateGnP(n, p, generator).first; });
+
+        report.measure("generateMST", "gnp", n, [&] { benchChecksum += GraphServices::generateMST(G).edges.size(); });
+    }
+}
+
+#endif  // ENGINE_BENCHMARKS
@@ -0,0 +1,126 @@
+#if !defined(BENCH_HARNESS)
+#define BENCH_HARNESS
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// timed results are added here and printed, so the work cannot be optimized away
+size_t benchChecksum = 0;
+
+/**
+ * Timings of one benchmark on one graph, every sample in nanoseconds.
+ */
+struct BenchResult {
+    std::string benchmark;
+    std::string family;
+    int nodes;
+    std::vector<double> samples;
+
+    /**
+     * The nearest-rank percentile, 50 is the median.
+     */
+    double percentile(double p) const {
+        std::vector<double> sorted = samples;
+        std::sort(sorted.begin(), sorted.end());
+        size_t rank = (size_t)std::ceil(p / 100 * sorted.size());
+        return sorted[std::clamp<size_t>(rank, 1, sorted.size()) - 1];
+    }
+
+    double mean() const {
+        double total = 0;
+        for (double sample : samples) total += sample;
+        return total / samples.size();
+    }
+};
+
+/**
+ * @class BenchReport
+ * @brief Runs benchmarks a fixed number of times and reports their timing distribution.
+ *
+ * Every benchmark runs once untimed to warm caches and allocations, then repetitions times.
+ * A table row is printed per benchmark as it finishes, and all results can be written as JSON.
+ */
+class BenchReport {
+public:
+    int repetitions;
+    std::vector<BenchResult> results;
+
+    explicit BenchReport(int runs) : repetitions(std::max(runs, 1)) {}
+
+    /**
+     * @brief Times body, calling prepare untimed before every run.
+     *
+     * @param operations Operations one run of body performs, samples are per operation.
+     */
+    template <typename Prepare, typename Body>
+    void measure(const std::string &benchmark, const std::string &family, int nodes, Prepare &&prepare, Body &&body,
+                 int operations = 1) {
+        BenchResult result = {benchmark, family, nodes, {}};
+
+        for (int run = -1; run < repetitions; run++) {
+            prepare();
+            auto start = std::chrono::steady_clock::now();
+            body();
+            std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+
+            if (run >= 0)
+                result.samples.push_back(elapsed.count() / operations);
+        }
+
+        printRow(result);
+        results.push_back(std::move(result));
+    }
+
+    template <typename Body>
+    void measure(const std::string &benchmark, const std::string &family, int nodes, Body &&body) {
+        measure(benchmark, family, nodes, [] {}, body);
+    }
+
+    void printHeader() const {
+        std::cout << std::left << std::setw(32) << "benchmark" << std::setw(18) << "family" << std::setw(10) << "nodes"
+                  << std::right << std::setw(14) << "median ns" << std::setw(14) << "p90 ns" << std::setw(14) << "p99 ns"
+                  << std::setw(14) << "min ns" << "\n";
+    }
+
+    /**
+     * @brief Writes every result as a JSON document.
+     * @return False if the file could not be written.
+     */
+    bool writeJSON(const std::string &path) const {
+        std::ofstream file(path, std::ios::trunc);
+        if (not file.is_open())
+            return false;
+
+        file << std::fixed << std::setprecision(1);
+        file << "{\n  \"unit\": \"ns\",\n  \"repetitions\": " << repetitions << ",\n  \"results\": [";
+        for (size_t i = 0; i < results.size(); i++) {
+            const BenchResult &result = results[i];
+            file << (i == 0 ? "\n" : ",\n") << "    {\"benchmark\": \"" << result.benchmark << "\", \"family\": \""
+                 << result.family << "\", \"nodes\": " << result.nodes << ", \"min\": " << result.percentile(0)
+                 << ", \"median\": " << result.percentile(50) << ", \"p90\": " << result.percentile(90)
+                 << ", \"p99\": " << result.percentile(99) << ", \"max\": " << result.percentile(100)
+                 << ", \"mean\": " << result.mean() << "}";
+        }
+        file << "\n  ]\n}\n";
+
+        return file.good();
+    }
+
+private:
+    void printRow(const BenchResult &result) const {
+        std::cout << std::left << std::setw(32) << result.benchmark << std::setw(18) << result.family << std::setw(10)
+                  << result.nodes << std::right << std::fixed << std::setprecision(0) << std::setw(14)
+                  << result.percentile(50) << std::setw(14) << result.percentile(90) << std::setw(14)
+                  << result.percentile(99) << std::setw(14) << result.percentile(0) << "\n";
+        std::cout.unsetf(std::ios::fixed);
+        std::cout << std::setprecision(6) << std::flush;
+    }
+};
+
+#endif  // BENCH_HARNESS
@@ -0,0 +1,71 @@
+#if !defined(TRAVEL_BENCHMARKS)
+#define TRAVEL_BENCHMARKS
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "../graph.hpp"
+
+/**
+ * Builds a random tree on n nodes where node v hangs from one of the previous
+ * 16 nodes, so a radius-r ball has roughly the same size for every n.
+ */
+Graph buildBenchmarkTree(int n, unsigned seed) {
+    std::mt19937 generator(seed);
+    Graph g(n);
+
+    for (int v = 2; v <= n; v++) {
+        std::uniform_int_distribution<int> parent(std::max(1, v - 16), v - 1);
+        g.add_edge(parent(generator), v);
+    }
+
+    std::uniform_int_distribution<int> smallColor(0, 8);
+    for (int v = 1; v <= n; v++) g.colors.set(v, smallColor(generator));
+
+    return g;
+}
+
+/**
+ * Times travelForColor with a fixed radius on trees of growing size.
+ * With the reusable workspace the time per call should stay flat as maxNodes grows.
+ */
+void bench_travelForColorPerCallCost() {
+    const int calls = 20000;
+    const int radius = 4;
+
+    std::cout << std::left << std::setw(12) << "maxNodes"
+              << std::setw(20) << "ns / travelForColor"
+              << std::setw(20) << "ns / ballScan" << "\n";
+
+    for (int n : {1000, 10000, 100000, 1000000}) {
+        Graph g = buildBenchmarkTree(n, 42);
+
+        std::mt19937 generator(7);
+        std::uniform_int_distribution<int> node(1, n);
+        std::vector<int> sources(calls);
+        for (auto &source : sources) source = node(generator);
+
+        size_t checksum = 0;
+
+        auto travel_start = std::chrono::high_resolution_clock::now();
+        for (int source : sources) checksum += g.travelForColor(Color(radius), source).count();
+        auto travel_end = std::chrono::high_resolution_clock::now();
+
+        auto scan_start = std::chrono::high_resolution_clock::now();
+        for (int source : sources) checksum += g.ballScanForColor(source, radius);
+        auto scan_end = std::chrono::high_resolution_clock::now();
+
+        std::chrono::duration<double, std::nano> travel = travel_end - travel_start;
+        std::chrono::duration<double, std::nano> scan = scan_end - scan_start;
+
+        std::cout << std::left << std::setw(12) << n
+                  << std::setw(20) << travel.count() / calls
+                  << std::setw(20) << scan.count() / calls
+                  << "(checksum " << checksum << ")\n";
+    }
+}
+
+#endif  // TRAVEL_BENCHMARKS
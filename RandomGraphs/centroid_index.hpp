@@ -0,0 +1,293 @@
+#if !defined(CENTROID_DECOMPOSITION)
+#define CENTROID_DECOMPOSITION
+
+#include <algorithm>
+#include <bit>
+#include <climits>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+/**
+ * @class CentroidColorIndex
+ * @brief Dynamic nearest-same-color index built on a centroid decomposition of a tree.
+ *
+ * Every node has one centroid ancestor per level of the decomposition (O(log n) of them)
+ * and every tree path u -> v passes through the deepest centroid shared by u and v.
+ * For each centroid the index keeps, per color, the distance to the closest marked node
+ * of its component, so
+ *   - mark(v, c) updates the O(log n) centroids above v,
+ *   - nearest(u, c) = min over centroids a above u of dist(u, a) + best(a, c).
+ * Both run in O(log n) lookups. Colors below DENSE_COLORS (color 1 covers most nodes) live
+ * in a flat array, rarer colors in an open addressing table keyed by (centroid, color).
+ *
+ * Only the component of the root is indexed, nodes outside it are infinitely far away.
+ */
+class CentroidColorIndex {
+public:
+    static constexpr int DENSE_COLORS = 4;
+
+    CentroidColorIndex() = default;
+
+    /**
+     * @brief Decomposes the tree that contains `root`.
+     *
+     * @param n The largest node ID.
+     * @param root Any node of the tree.
+     * @param neighbors Callable returning the neighbors of a node as an iterable range.
+     * @return False if the component of the root contains a cycle, the index is then left empty.
+     */
+    template <typename Neighbors>
+    bool build(int n, int root, Neighbors &&neighbors) {
+        clear();
+        maxNodes = n;
+
+        if (not isTree(root, neighbors))
+            return false;
+
+        // a centroid level at least halves the component, so there are at most bit_width(n) levels
+        levelStride = std::bit_width((unsigned)std::max(n, 1));
+        ancestors.assign((size_t)(n + 1) * levelStride, {0, 0});
+        centroidLevel.assign(n + 1, -1);
+        std::vector<int> subtreeSize(n + 1, 0), parent(n + 1, 0), order, distance(n + 1, 0);
+
+        // components are decomposed level by level, the centroid of a component is
+        // an ancestor of every node in it at the level of the component
+        std::vector<int> components = {root}, nextComponents;
+        for (int level = 0; not components.empty(); level++) {
+            nextComponents.clear();
+
+            for (int start : components) {
+                // subtree sizes of the component rooted at start, in DFS order
+                order.clear();
+                order.push_back(start);
+                parent[start] = 0;
+                for (size_t i = 0; i < order.size(); i++) {
+                    int node = order[i];
+                    for (int nbr : neighbors(node)) {
+                        if (nbr != parent[node] and centroidLevel[nbr] == -1) {
+                            parent[nbr] = node;
+                            order.push_back(nbr);
+                        }
+                    }
+                }
+
+                for (int i = order.size() - 1; i >= 0; i--) {
+                    int node = order[i];
+                    subtreeSize[node] = 1;
+                    for (int nbr : neighbors(node)) {
+                        if (nbr != parent[node] and centroidLevel[nbr] == -1)
+                            subtreeSize[node] += subtreeSize[nbr];
+                    }
+                }
+
+                // walk towards the heavy child until no part is larger than half
+                int total = order.size(), centroid = start;
+                for (bool moved = true; moved;) {
+                    moved = false;
+                    for (int nbr : neighbors(centroid)) {
+                        if (nbr != parent[centroid] and centroidLevel[nbr] == -1 and subtreeSize[nbr] * 2 > total) {
+                            centroid = nbr;
+                            moved = true;
+                            break;
+                        }
+                    }
+                }
+
+                // distances from the centroid to its whole component
+                centroidLevel[centroid] = level;
+                order.clear();
+                order.push_back(centroid);
+                parent[centroid] = 0;
+                distance[centroid] = 0;
+                for (size_t i = 0; i < order.size(); i++) {
+                    int node = order[i];
+                    ancestors[(size_t)node * levelStride + level] = {centroid, distance[node]};
+
+                    for (int nbr : neighbors(node)) {
+                        if (nbr != parent[node] and centroidLevel[nbr] == -1) {
+                            parent[nbr] = node;
+                            distance[nbr] = distance[node] + 1;
+                            order.push_back(nbr);
+                        }
+                    }
+                }
+
+                for (int nbr : neighbors(centroid)) {
+                    if (centroidLevel[nbr] == -1)
+                        nextComponents.push_back(nbr);
+                }
+            }
+
+            components.swap(nextComponents);
+        }
+
+        denseBest.assign((size_t)(n + 1) * DENSE_COLORS, INT_MAX);
+        return true;
+    }
+
+    /**
+     * @brief Records that node v holds color.
+     */
+    void mark(int v, int color) {
+        if (empty() or centroidLevel[v] == -1)
+            return;
+
+        const std::pair<int, int> *above = &ancestors[(size_t)v * levelStride];
+        for (int level = 0; level <= centroidLevel[v]; level++) {
+            int &best = bestSlot(above[level].first, color);
+            best = std::min(best, above[level].second);
+        }
+    }
+
+    /**
+     * @brief Distance from u to the closest node marked with color, INT_MAX if there is none.
+     */
+    int nearest(int u, int color) const {
+        if (empty() or centroidLevel[u] == -1)
+            return INT_MAX;
+
+        const std::pair<int, int> *above = &ancestors[(size_t)u * levelStride];
+        int closest = INT_MAX;
+        for (int level = 0; level <= centroidLevel[u]; level++) {
+            int best = findBest(above[level].first, color);
+            if (best != INT_MAX)
+                closest = std::min(closest, best + above[level].second);
+        }
+        return closest;
+    }
+
+    /**
+     * @brief True if some node marked with color lies within distance radius of u.
+     *
+     * Cheaper than comparing nearest() with radius: centroids farther than radius from u
+     * cannot lead to such a node and are skipped, and the scan stops at the first hit.
+     */
+    bool isMarkedWithin(int u, int color, int radius) const {
+        if (empty() or centroidLevel[u] == -1)
+            return false;
+
+        const std::pair<int, int> *above = &ancestors[(size_t)u * levelStride];
+        for (int level = 0; level <= centroidLevel[u]; level++) {
+            int distance = above[level].second;
+            if (distance > radius)
+                continue;
+
+            int best = findBest(above[level].first, color);
+            if (best != INT_MAX and best + distance <= radius)
+                return true;
+        }
+        return false;
+    }
+
+    bool empty() const {
+        return centroidLevel.empty();
+    }
+
+    void clear() {
+        centroidLevel = std::vector<int>();
+        ancestors = std::vector<std::pair<int, int>>();
+        denseBest = std::vector<int>();
+        keys = std::vector<uint64_t>();
+        values = std::vector<int>();
+        used = 0;
+    }
+
+private:
+    static constexpr uint64_t EMPTY_KEY = ~uint64_t(0);
+
+    int maxNodes = 0;
+    std::vector<int> centroidLevel;               // level at which a node is a centroid
+    int levelStride = 0;
+    std::vector<std::pair<int, int>> ancestors;   // [v * levelStride + level]: centroid above v and its distance
+    std::vector<int> denseBest;                   // best distance of colors below DENSE_COLORS
+    std::vector<uint64_t> keys;                   // (centroid, color) of rarer colors
+    std::vector<int> values;
+    size_t used = 0;
+
+    template <typename Neighbors>
+    bool isTree(int root, Neighbors &neighbors) const {
+        std::vector<bool> seen(maxNodes + 1, false);
+        std::vector<int> stack = {root};
+        seen[root] = true;
+        long long nodes = 0, endpoints = 0;
+
+        while (not stack.empty()) {
+            int node = stack.back();
+            stack.pop_back();
+            nodes++;
+
+            for (int nbr : neighbors(node)) {
+                endpoints++;
+                if (not seen[nbr]) {
+                    seen[nbr] = true;
+                    stack.push_back(nbr);
+                }
+            }
+        }
+
+        return endpoints / 2 == nodes - 1;
+    }
+
+    static uint64_t keyOf(int centroid, int color) {
+        return (uint64_t)(uint32_t)centroid << 32 | (uint32_t)color;
+    }
+
+    static size_t slotOf(uint64_t key, size_t mask) {
+        return (key * 0x9E3779B97F4A7C15ull >> 20) & mask;
+    }
+
+    int &bestSlot(int centroid, int color) {
+        if (color < DENSE_COLORS)
+            return denseBest[(size_t)centroid * DENSE_COLORS + color];
+
+        if ((used + 1) * 2 > keys.size())
+            rehash(keys.empty() ? 1024 : keys.size() * 2);
+
+        uint64_t key = keyOf(centroid, color);
+        size_t mask = keys.size() - 1, slot = slotOf(key, mask);
+        while (keys[slot] != key and keys[slot] != EMPTY_KEY) slot = (slot + 1) & mask;
+
+        if (keys[slot] == EMPTY_KEY) {
+            keys[slot] = key;
+            values[slot] = INT_MAX;
+            used++;
+        }
+        return values[slot];
+    }
+
+    int findBest(int centroid, int color) const {
+        if (color < DENSE_COLORS)
+            return denseBest[(size_t)centroid * DENSE_COLORS + color];
+        if (keys.empty())
+            return INT_MAX;
+
+        uint64_t key = keyOf(centroid, color);
+        size_t mask = keys.size() - 1, slot = slotOf(key, mask);
+        while (keys[slot] != EMPTY_KEY) {
+            if (keys[slot] == key)
+                return values[slot];
+            slot = (slot + 1) & mask;
+        }
+        return INT_MAX;
+    }
+
+    void rehash(size_t capacity) {
+        std::vector<uint64_t> oldKeys(capacity, EMPTY_KEY);
+        std::vector<int> oldValues(capacity, INT_MAX);
+        oldKeys.swap(keys);
+        oldValues.swap(values);
+
+        size_t mask = capacity - 1;
+        for (size_t i = 0; i < oldKeys.size(); i++) {
+            if (oldKeys[i] == EMPTY_KEY)
+                continue;
+            size_t slot = slotOf(oldKeys[i], mask);
+            while (keys[slot] != EMPTY_KEY) slot = (slot + 1) & mask;
+            keys[slot] = oldKeys[i];
+            values[slot] = oldValues[i];
+        }
+    }
+};
+
+#endif  // CENTROID_DECOMPOSITION
@@ -0,0 +1,212 @@
+#if !defined(COLOR_ARRAY)
+#define COLOR_ARRAY
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <vector>
+
+/**
+ * @class PackedColors
+ * @brief The color ID of every node stored in a fixed width unsigned integer.
+ *
+ * Nodes are numbered from 1, index 0 is kept so node IDs index directly and is left out of
+ * the bulk operations.
+ */
+template <typename Width>
+class PackedColors {
+public:
+    static constexpr int MAX_COLOR = std::numeric_limits<Width>::max();
+
+    PackedColors(int size = 0, int color = 0) : ids(size, (Width)color) {}
+
+    /**
+     * @brief Copies the colors of a narrower storage.
+     */
+    template <typename Narrower>
+    explicit PackedColors(const PackedColors<Narrower> &other) : ids(other.ids.begin(), other.ids.end()) {}
+
+    int operator[](int node) const {
+        return ids[node];
+    }
+
+    void set(int node, int color) {
+        ids[node] = (Width)color;
+    }
+
+    void fill(std::span<const int> nodes, int color) {
+        for (int node : nodes) ids[node] = (Width)color;
+    }
+
+    int max() const {
+        if (ids.size() <= 1)
+            return 0;
+        return *std::max_element(ids.begin() + 1, ids.end());
+    }
+
+    /**
+     * @brief Adds the number of nodes holding every color to counts, which must have room for max().
+     */
+    void countInto(std::vector<int> &counts) const {
+        for (size_t node = 1; node < ids.size(); node++) counts[ids[node]]++;
+    }
+
+    std::vector<Width> ids;
+};
+
+/**
+ * @class ColorArray
+ * @brief The color ID of every node of a graph, stored in as few bytes per node as its colors allow.
+ *
+ * Colors start as 8 bit integers and the whole array is promoted to 16, then 32 bits the
+ * first time a color does not fit. Almost every node of a packing coloring holds a small
+ * color, so the BFS ball scans read a quarter of the memory a vector<Color> would take.
+ * Reads dispatch on the current width, a branch that always goes the same way.
+ *
+ * Promotion reallocates, so concurrent readers are only safe while nothing is written.
+ */
+class ColorArray {
+public:
+    /**
+     * @brief Constructs an array for node IDs in [0, size), every node holding color.
+     */
+    ColorArray(int size = 0, int color = 0) {
+        assign(size, color);
+    }
+
+    /**
+     * @brief Resizes the array to node IDs in [0, size) and gives every node color,
+     * at the narrowest width that holds it.
+     */
+    void assign(int size, int color) {
+        narrow = PackedColors<uint8_t>();
+        medium = PackedColors<uint16_t>();
+        wide = PackedColors<uint32_t>();
+        nodeCount = size;
+
+        if (color <= PackedColors<uint8_t>::MAX_COLOR) {
+            bytes = 1;
+            narrow = PackedColors<uint8_t>(size, color);
+        } else if (color <= PackedColors<uint16_t>::MAX_COLOR) {
+            bytes = 2;
+            medium = PackedColors<uint16_t>(size, color);
+        } else {
+            bytes = 4;
+            wide = PackedColors<uint32_t>(size, color);
+        }
+    }
+
+    int operator[](int node) const {
+        switch (bytes) {
+            case 1:
+                return narrow[node];
+            case 2:
+                return medium[node];
+            default:
+                return wide[node];
+        }
+    }
+
+    /**
+     * @brief Colors a node, promoting the array first if the color does not fit its width.
+     */
+    void set(int node, int color) {
+        widenFor(color);
+        switch (bytes) {
+            case 1:
+                narrow.set(node, color);
+                break;
+            case 2:
+                medium.set(node, color);
+                break;
+            default:
+                wide.set(node, color);
+        }
+    }
+
+    /**
+     * @brief Gives every listed node the same color, e.g. a whole level, with one width check.
+     */
+    void fill(std::span<const int> nodes, int color) {
+        widenFor(color);
+        switch (bytes) {
+            case 1:
+                narrow.fill(nodes, color);
+                break;
+            case 2:
+                medium.fill(nodes, color);
+                break;
+            default:
+                wide.fill(nodes, color);
+        }
+    }
+
+    /**
+     * @brief The largest color held by a node, 0 when there are no nodes.
+     */
+    int max() const {
+        switch (bytes) {
+            case 1:
+                return narrow.max();
+            case 2:
+                return medium.max();
+            default:
+                return wide.max();
+        }
+    }
+
+    /**
+     * @brief Counts the nodes holding every color.
+     * @param minColors The histogram has at least this many entries, so callers may read fixed colors.
+     * @return The number of nodes holding color c at index c, for every c up to max().
+     */
+    std::vector<int> histogram(int minColors = 0) const {
+        std::vector<int> counts(std::max(max() + 1, minColors), 0);
+        switch (bytes) {
+            case 1:
+                narrow.countInto(counts);
+                break;
+            case 2:
+                medium.countInto(counts);
+                break;
+            default:
+                wide.countInto(counts);
+        }
+        return counts;
+    }
+
+    int size() const {
+        return nodeCount;
+    }
+
+    /**
+     * @brief Bytes used to store the color of one node, 1, 2 or 4.
+     */
+    int bytesPerColor() const {
+        return bytes;
+    }
+
+private:
+    void widenFor(int color) {
+        if (bytes == 1 and color > PackedColors<uint8_t>::MAX_COLOR) {
+            medium = PackedColors<uint16_t>(narrow);
+            narrow = PackedColors<uint8_t>();
+            bytes = 2;
+        }
+        if (bytes == 2 and color > PackedColors<uint16_t>::MAX_COLOR) {
+            wide = PackedColors<uint32_t>(medium);
+            medium = PackedColors<uint16_t>();
+            bytes = 4;
+        }
+    }
+
+    // only the storage of the current width is non-empty
+    PackedColors<uint8_t> narrow;
+    PackedColors<uint16_t> medium;
+    PackedColors<uint32_t> wide;
+    int bytes = 1;
+    int nodeCount = 0;
+};
+
+#endif  // COLOR_ARRAY
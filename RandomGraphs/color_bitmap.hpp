@@ -0,0 +1,102 @@
+#if !defined(COLOR_BITMAP)
+#define COLOR_BITMAP
+
+#include <bit>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @class ColorPresenceBitmap
+ * @brief Dense set of the colors seen inside a BFS ball, one bit per color ID.
+ *
+ * Storage is sized once for the largest color that may be queried, clearing only
+ * resets the words that were written since the last clear, and the next color that
+ * is not present is found with word-level scans. No call allocates.
+ */
+class ColorPresenceBitmap {
+public:
+    /**
+     * @brief Constructs a bitmap for color IDs in [0, maxColor].
+     * @param maxColor The largest color ID that can be stored.
+     */
+    ColorPresenceBitmap(int maxColor = 0) {
+        resize(maxColor);
+    }
+
+    /**
+     * @brief Makes room for color IDs in [0, maxColor] and empties the bitmap.
+     * @param maxColor The largest color ID that can be stored.
+     */
+    void resize(int maxColor) {
+        bitCount = maxColor + 1;
+        words.assign((bitCount + 63) / 64, 0);
+        touchedWords.clear();
+    }
+
+    /**
+     * @brief Removes every color, in time proportional to the words written since the last clear.
+     */
+    void clear() {
+        for (int word : touchedWords) words[word] = 0;
+        touchedWords.clear();
+    }
+
+    /**
+     * @brief Marks a color as present. Colors above the capacity are ignored,
+     * they can never be queried.
+     * @param color The color ID to insert.
+     */
+    void insert(int color) {
+        if (color < 0 or color >= bitCount)
+            return;
+
+        uint64_t &word = words[color >> 6];
+        if (word == 0)
+            touchedWords.push_back(color >> 6);
+        word |= uint64_t(1) << (color & 63);
+    }
+
+    bool test(int color) const {
+        if (color < 0 or color >= bitCount)
+            return false;
+        return (words[color >> 6] >> (color & 63)) & 1;
+    }
+
+    /**
+     * @brief Finds the smallest color ID greater than or equal to `color` that is not present.
+     * @param color The color ID to start the scan from.
+     * @return The first absent color ID, or the capacity (largest color + 1) if all are present.
+     */
+    int firstAbsentFrom(int color) const {
+        if (color >= bitCount)
+            return bitCount;
+
+        int word = color >> 6;
+        uint64_t absent = ~words[word] & (~uint64_t(0) << (color & 63));
+
+        while (absent == 0) {
+            if (++word == (int)words.size())
+                return bitCount;
+            absent = ~words[word];
+        }
+
+        int found = (word << 6) + std::countr_zero(absent);
+        return found < bitCount ? found : bitCount;
+    }
+
+    /**
+     * @brief Counts the colors present.
+     */
+    int count() const {
+        int present = 0;
+        for (int word : touchedWords) present += std::popcount(words[word]);
+        return present;
+    }
+
+private:
+    std::vector<uint64_t> words;
+    std::vector<int> touchedWords;  // words that became non-zero since the last clear
+    int bitCount = 0;
+};
+
+#endif  // COLOR_BITMAP
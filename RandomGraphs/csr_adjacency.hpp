@@ -0,0 +1,123 @@
+#if !defined(CSR_ADJACENCY)
+#define CSR_ADJACENCY
+
+#include <memory>
+#include <span>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/**
+ * @class CSRAdjacency
+ * @brief Compressed sparse row adjacency of an undirected graph.
+ *
+ * The neighbors of node v are neighbors[offsets[v] .. offsets[v + 1]), stored in two flat
+ * arrays instead of one heap block per node. Neighbors keep the order in which their edges
+ * appear in the edge list, the same order add_edge produces with adjacency lists.
+ *
+ * The arrays are views of an immutable block shared by every copy, either built here or a
+ * memory-mapped graph file, so copying an adjacency never copies its arrays.
+ */
+class CSRAdjacency {
+public:
+    std::span<const int> offsets;    // n + 2 entries, node IDs are 0..n
+    std::span<const int> neighbors;  // 2 * m entries
+
+    CSRAdjacency() = default;
+
+    /**
+     * @brief Builds the adjacency of nodes [0, n] from an undirected edge list in two passes,
+     * one counting degrees and one placing neighbors.
+     *
+     * @param n The largest node ID.
+     * @param edges The undirected edges, each stored once.
+     */
+    CSRAdjacency(int n, const std::vector<std::pair<int, int>> &edges)
+        : CSRAdjacency(n, [&edges](auto &&emit) {
+              for (auto &edge : edges) emit(edge.first, edge.second);
+              return true;
+          }) {}
+
+    /**
+     * @brief Builds the adjacency from edges that are replayed instead of stored, e.g. decoded
+     * from a file once per pass, so no edge list is ever held in memory.
+     *
+     * @param n The largest node ID.
+     * @param replayEdges Callable taking an edge sink emit(u, v), it calls the sink once for
+     * every undirected edge in the same order on every call and returns false on failure.
+     * The adjacency is left empty if a replay fails or replays differ.
+     */
+    template <typename EdgeReplay>
+        requires std::is_invocable_v<EdgeReplay &, void (*)(int, int)>
+    CSRAdjacency(int n, EdgeReplay &&replayEdges) {
+        auto built = std::make_shared<BuiltArrays>();
+        std::vector<int> &ownedOffsets = built->offsets, &ownedNeighbors = built->neighbors;
+        ownedOffsets.assign(n + 2, 0);
+
+        // pass 1: degree of node v is counted at ownedOffsets[v + 1]
+        bool replayed = replayEdges([&](int u, int v) {
+            ownedOffsets[u + 1]++;
+            ownedOffsets[v + 1]++;
+        });
+        if (not replayed)
+            return;
+
+        for (int v = 1; v <= n + 1; v++) ownedOffsets[v] += ownedOffsets[v - 1];
+
+        // pass 2: place every neighbor at the next free slot of its node
+        ownedNeighbors.resize(ownedOffsets[n + 1]);
+        std::vector<int> next(ownedOffsets.begin(), ownedOffsets.end() - 1);
+
+        // a node whose slots are full means the replay differs from the counted one
+        size_t placed = 0;
+        bool consistent = true;
+        replayed = replayEdges([&](int u, int v) {
+            if (next[u] == ownedOffsets[u + 1] or next[v] == ownedOffsets[v + 1]) {
+                consistent = false;
+                return;
+            }
+            ownedNeighbors[next[u]++] = v;
+            ownedNeighbors[next[v]++] = u;
+            placed += 2;
+        });
+        if (not replayed or not consistent or placed != ownedNeighbors.size())
+            return;
+
+        offsets = ownedOffsets;
+        neighbors = ownedNeighbors;
+        storage = std::move(built);
+    }
+
+    /**
+     * @brief Views arrays that owner keeps alive, e.g. the sections of a mapped graph file.
+     */
+    CSRAdjacency(std::span<const int> offsetView, std::span<const int> neighborView, std::shared_ptr<const void> owner)
+        : offsets(offsetView), neighbors(neighborView), storage(std::move(owner)) {}
+
+    std::span<const int> operator[](int node) const {
+        return std::span<const int>(neighbors.data() + offsets[node], offsets[node + 1] - offsets[node]);
+    }
+
+    int degree(int node) const {
+        return offsets[node + 1] - offsets[node];
+    }
+
+    bool empty() const {
+        return offsets.empty();
+    }
+
+    void clear() {
+        offsets = {};
+        neighbors = {};
+        storage.reset();
+    }
+
+private:
+    struct BuiltArrays {
+        std::vector<int> offsets, neighbors;
+    };
+
+    std::shared_ptr<const void> storage;  // owns the arrays behind the views
+};
+
+#endif  // CSR_ADJACENCY
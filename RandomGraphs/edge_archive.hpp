@@ -0,0 +1,278 @@
+#if !defined(EDGE_ARCHIVE)
+#define EDGE_ARCHIVE
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "csr_adjacency.hpp"
+#include "graph.hpp"
+
+/**
+ * @namespace EdgeArchive
+ * @brief Compressed edge files, decoded block by block straight into a graph.
+ *
+ * Every edge is stored as (smaller ID, larger ID), the edges sorted by source and then by target.
+ * The sorted list is cut into blocks of a fixed number of edges and every edge is written as two
+ * LEB128 varints:
+ *   source - previous source                  0 for the rest of a source's run
+ *   target - previous target of the run       target - source for the first edge of a run
+ * The first edge of a block is relative to the block's first source, kept in the index, so each
+ * block decodes on its own. Runs of one source, like the "1 88", "1 152", ... of an MST, shrink to
+ * one or two bytes per edge instead of a decimal line.
+ *
+ * A file is a Header, then blockCount BlockEntry records, then the block payloads.
+ */
+namespace EdgeArchive {
+constexpr char MAGIC[8] = {'P', 'C', 'E', 'D', 'G', 'A', 'R', 'C'};
+constexpr uint32_t VERSION = 1;
+constexpr uint32_t DEFAULT_BLOCK_EDGES = 1 << 16;
+
+struct Header {
+    char magic[8];
+    uint32_t version;
+    int32_t nodes;
+    int64_t edges;
+    uint32_t blockEdges;
+    uint32_t blockCount;
+};
+
+struct BlockEntry {
+    uint64_t offset;  // from the start of the first payload
+    uint32_t bytes;
+    uint32_t edges;
+    int32_t firstSource;
+    int32_t reserved;
+};
+
+inline void appendVarint(std::vector<uint8_t> &bytes, uint32_t value) {
+    while (value >= 0x80) {
+        bytes.push_back((uint8_t)(value | 0x80));
+        value >>= 7;
+    }
+    bytes.push_back((uint8_t)value);
+}
+
+/**
+ * @brief Reads one varint at cursor and advances it.
+ * @return False if the varint runs past end or does not fit 32 bits.
+ */
+inline bool readVarint(const uint8_t *&cursor, const uint8_t *end, uint32_t &value) {
+    value = 0;
+    for (int shift = 0; shift < 35 and cursor != end; shift += 7) {
+        uint8_t byte = *cursor++;
+        value |= (uint32_t)(byte & 0x7f) << shift;
+        if ((byte & 0x80) == 0)
+            return shift < 28 or byte < 0x10;
+    }
+    return false;
+}
+
+/**
+ * @brief Decodes one block and emits its edges in stored order.
+ * @return False if the payload is malformed or names a node above nodes.
+ */
+template <typename EdgeSink>
+bool decodeBlock(const BlockEntry &block, const uint8_t *payload, int nodes, EdgeSink &&emit) {
+    const uint8_t *cursor = payload, *end = payload + block.bytes;
+    int64_t source = block.firstSource, target = 0;
+
+    for (uint32_t e = 0; e < block.edges; e++) {
+        uint32_t sourceDelta, targetDelta;
+        if (not readVarint(cursor, end, sourceDelta) or not readVarint(cursor, end, targetDelta))
+            return false;
+
+        bool newRun = e == 0 or sourceDelta != 0;
+        source += sourceDelta;
+        target = (newRun ? source : target) + targetDelta;
+        if (source < 0 or target > nodes)
+            return false;
+
+        emit((int)source, (int)target);
+    }
+
+    return cursor == end;
+}
+
+/**
+ * @class Reader
+ * @brief Streams the blocks of an archive from disk, holding one block payload at a time.
+ */
+class Reader {
+public:
+    Header header;
+    std::vector<BlockEntry> blocks;
+
+    /**
+     * @brief Opens an archive and reads its header and block index, test the reader before use.
+     *
+     * The index and every block it lists must lie inside the file before anything is sized from
+     * them, so a corrupt count cannot make the reader allocate more than the file holds.
+     */
+    explicit Reader(const std::string &path) : file(path, std::ios::binary | std::ios::ate) {
+        std::streamoff length = file.tellg();
+        file.seekg(0);
+
+        valid = length >= (std::streamoff)sizeof(header) and
+                file.read(reinterpret_cast<char *>(&header), sizeof(header)) and
+                std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) == 0 and header.version == VERSION and
+                header.nodes >= 0 and header.edges >= 0 and
+                header.blockCount <= (uint64_t)(length - sizeof(header)) / sizeof(BlockEntry);
+        if (not valid)
+            return;
+
+        blocks.resize(header.blockCount);
+        valid = (bool)file.read(reinterpret_cast<char *>(blocks.data()), blocks.size() * sizeof(BlockEntry));
+        payloadStart = file.tellg();
+
+        // every edge takes at least two bytes, one varint per endpoint
+        uint64_t payloadBytes = length - payloadStart;
+        int64_t indexedEdges = 0;
+        for (auto &block : blocks) {
+            valid = valid and block.offset <= payloadBytes and block.bytes <= payloadBytes - block.offset and
+                    block.edges <= block.bytes / 2;
+            indexedEdges += block.edges;
+        }
+        valid = valid and indexedEdges == header.edges;
+    }
+
+    explicit operator bool() const {
+        return valid;
+    }
+
+    /**
+     * @brief Decodes one block, independently of every other.
+     */
+    template <typename EdgeSink>
+    bool forEachEdgeIn(size_t blockID, EdgeSink &&emit) {
+        const BlockEntry &block = blocks[blockID];
+        payload.resize(block.bytes);
+
+        file.clear();
+        file.seekg(payloadStart + (std::streamoff)block.offset);
+        if (not file.read(reinterpret_cast<char *>(payload.data()), block.bytes))
+            return false;
+
+        return decodeBlock(block, payload.data(), header.nodes, emit);
+    }
+
+    /**
+     * @brief Decodes every block in order, emitting the edges sorted by source.
+     */
+    template <typename EdgeSink>
+    bool forEachEdge(EdgeSink &&emit) {
+        if (not valid)
+            return false;
+
+        for (size_t blockID = 0; blockID < blocks.size(); blockID++) {
+            if (not forEachEdgeIn(blockID, emit))
+                return false;
+        }
+        return true;
+    }
+
+private:
+    std::ifstream file;
+    std::streamoff payloadStart = 0;
+    std::vector<uint8_t> payload;  // the block being decoded
+    bool valid = false;
+};
+
+/**
+ * @brief Writes the edges of a graph on nodes [1, nodes] as an archive.
+ *
+ * @param blockEdges Edges per block, the unit that is read and decoded on its own.
+ * @return False if the file could not be written.
+ */
+bool write(const std::string &path, int nodes, std::vector<std::pair<int, int>> edges,
+           uint32_t blockEdges = DEFAULT_BLOCK_EDGES) {
+    for (auto &edge : edges) {
+        if (edge.first > edge.second)
+            std::swap(edge.first, edge.second);
+    }
+    std::sort(edges.begin(), edges.end());
+
+    blockEdges = std::max(blockEdges, 1u);
+    std::vector<BlockEntry> blocks;
+    std::vector<uint8_t> payload;
+
+    for (size_t first = 0; first < edges.size(); first += blockEdges) {
+        size_t last = std::min(edges.size(), first + blockEdges);
+        BlockEntry block = {payload.size(), 0, (uint32_t)(last - first), edges[first].first, 0};
+
+        int source = block.firstSource, target = 0;
+        for (size_t e = first; e < last; e++) {
+            bool newRun = e == first or edges[e].first != source;
+            appendVarint(payload, edges[e].first - source);
+            appendVarint(payload, edges[e].second - (newRun ? edges[e].first : target));
+            source = edges[e].first;
+            target = edges[e].second;
+        }
+
+        block.bytes = payload.size() - block.offset;
+        blocks.push_back(block);
+    }
+
+    Header header;
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.nodes = nodes;
+    header.edges = edges.size();
+    header.blockEdges = blockEdges;
+    header.blockCount = blocks.size();
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (not file.is_open())
+        return false;
+
+    file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char *>(blocks.data()), blocks.size() * sizeof(BlockEntry));
+    file.write(reinterpret_cast<const char *>(payload.data()), payload.size());
+    return file.good();
+}
+
+/**
+ * @brief Builds a graph from an archive, decoding it twice into CSR adjacency and never
+ * holding its edge list, which is left empty like the one of a mapped graph.
+ *
+ * @return False if the archive could not be read, graph is then left untouched.
+ */
+bool load(const std::string &path, Graph &graph) {
+    Reader reader(path);
+    if (not reader)
+        return false;
+
+    CSRAdjacency adjacency(reader.header.nodes, [&reader](auto &&emit) { return reader.forEachEdge(emit); });
+    if (adjacency.empty())
+        return false;
+
+    graph = Graph(reader.header.nodes, std::move(adjacency));
+    return true;
+}
+
+/**
+ * @brief Converts a text edge file of "u v" lines, as writeMSTEdgesToAFile writes them, to an archive.
+ *
+ * @return False if either file could not be opened.
+ */
+bool convertEdgeFile(const std::string &textPath, const std::string &archivePath) {
+    std::ifstream text(textPath);
+    if (not text.is_open())
+        return false;
+
+    std::vector<std::pair<int, int>> edges;
+    int maxNodeID = 0;
+    for (int from, to; text >> from >> to;) {
+        edges.push_back({from, to});
+        maxNodeID = std::max({maxNodeID, from, to});
+    }
+
+    return write(archivePath, maxNodeID, std::move(edges));
+}
+};  // namespace EdgeArchive
+
+#endif  // EDGE_ARCHIVE
@@ -3,89 +3,195 @@
 
 #include <string.h>
 
+#include <algorithm>
+#include <atomic>
+#include <cmath>
 #include <ctime>
 #include <fstream>
 #include <iostream>
+#include <map>
 #include <queue>
 #include <set>
+#include <span>
+#include <unordered_set>
 #include <vector>
 #include <random>
 
 #include "UnionFind.hpp"
+#include "centroid_index.hpp"
 #include "color.h"
+#include "color_array.hpp"
+#include "color_bitmap.hpp"
+#include "csr_adjacency.hpp"
+#include "lca_oracle.hpp"
+#include "level_order.hpp"
+#include "thread_team.hpp"
+#include "traversal_workspace.hpp"
 #include "tree.h"
 
 using namespace std;
 
+/**
+ * How approximatePackingColor decides whether a color fits a candidate.
+ * Both engines produce the same coloring.
+ */
+enum class PackingColorEngine {
+    BALL_SCAN,       // bounded BFS ball, rare colors checked with the LCA distance oracle
+    CENTROID_INDEX,  // nearest-same-color queries on a centroid decomposition, no BFS at all
+};
+
+/**
+ * The BFS workspace and color bitmap one thread searches with while a level is colored in parallel.
+ */
+struct ColoringThreadScratch {
+    TraversalWorkspace workspace;
+    ColorPresenceBitmap colorsWithinRadius;
+    long long visitedNodes = 0;
+    long long oracleQueries = 0;
+
+    ColoringThreadScratch(int n) : workspace(n), colorsWithinRadius(n) {}
+};
+
 class Graph {
 public:
+    // levels with fewer uncolored candidates are colored sequentially even when coloringThreads > 1
+    static constexpr int PARALLEL_COLORING_MIN_CANDIDATES = 512;
+    // candidates searched concurrently per thread before the results are committed
+    static constexpr int PARALLEL_COLORING_CHUNK_PER_THREAD = 256;
+
     vector<vector<int>> adj_list;
-    vector<Color> colors;
-    vector<vector<int>> levelOrderTraversal;
-    vector<vector<int>> levelOrderTraversalSorted;
+    ColorArray colors;  // color ID of every node, 0 while uncolored
+    LevelOrder levelOrderTraversal;
+    vector<int> levelOrderTraversalSorted;  // level IDs of levelOrderTraversal, largest level first
     int maxNodes;
     std::vector<pair<int, int>> edges;
+    CSRAdjacency csr;              // when built, replaces adj_list
+    TraversalWorkspace workspace;  // reused by every bounded BFS on this graph
+    ColorPresenceBitmap colorsWithinRadius;  // colors seen by the last bounded BFS
+
+    PackingColorEngine engine = PackingColorEngine::BALL_SCAN;
+    CentroidColorIndex centroidIndex;  // only built while approximatePackingColor runs
+
+    // colors held by at most this many nodes are checked against their holders with
+    // distanceOracle instead of growing the BFS ball, 0 disables the oracle.
+    int distanceOracleHolderLimit = 64;
+    LCADistanceOracle distanceOracle;  // only built while approximatePackingColor runs
+    vector<vector<int>> nodesWithColor;
+
+    // threads used by approximatePackingColor to color the candidates of a level, 1 runs sequentially.
+    // every thread owns its own BFS workspace and color bitmap, O(maxNodes) memory each.
+    int coloringThreads = 1;
+
+    // work done by the last approximatePackingColor call
+    long long ballScanVisitedNodes = 0;
+    long long distanceOracleQueries = 0;
 
-    Graph(int n) {
+    Graph(int n) : workspace(n), colorsWithinRadius(n) {
         maxNodes = n;
+        adj_list.resize(n + 1);
+        colors.assign(n + 1, 0);
+    }
 
-        for (int i = 0; i <= n; i++) {
-            vector<int> v;
-            adj_list.push_back(v);
-        }
+    /**
+     * Builds a graph from an edge list straight into CSR adjacency,
+     * without growing one adjacency list per node.
+     *
+     * @param n The number of nodes.
+     * @param edgeList The undirected edges, each given once.
+     */
+    Graph(int n, vector<pair<int, int>> edgeList) : workspace(n), colorsWithinRadius(n) {
+        maxNodes = n;
+        edges = std::move(edgeList);
+        csr = CSRAdjacency(n, edges);
+        colors.assign(n + 1, 0);
+    }
 
-        colors = vector<Color>(n + 1, Color(0));
+    /**
+     * Makes a graph over a ready CSR adjacency, e.g. a mapped graph file, without copying it.
+     * The edge list is left empty, expandAdjacency rebuilds it.
+     *
+     * @param n The number of nodes.
+     * @param adjacency The adjacency of nodes [0, n].
+     */
+    Graph(int n, CSRAdjacency adjacency) : workspace(n), colorsWithinRadius(n) {
+        maxNodes = n;
+        csr = std::move(adjacency);
+        colors.assign(n + 1, 0);
     }
 
     /**
      * Adds an edge between two vertices in the graph.
+     * A graph in CSR form is first expanded back to adjacency lists.
      *
      * @param from The starting vertex of the edge.
      * @param to The ending vertex of the edge.
      */
     void add_edge(int from, int to) {
+        if (not csr.empty())
+            expandAdjacency();
+
         adj_list[from].push_back(to);
         adj_list[to].push_back(from);
 
         edges.push_back({from, to});
+        levelOrderTraversal.clear();
     }
 
-    friend std::ostream &operator<<(std::ostream &, Graph &);
+    /**
+     * Neighbors of a node, read from the CSR adjacency when it is built
+     * and from the adjacency lists otherwise.
+     */
+    std::span<const int> neighbors(int node) const {
+        if (not csr.empty())
+            return csr[node];
+        return adj_list[node];
+    }
 
     /**
-     * Calculates the level order traversal of the tree starting from the given root node.
-     * The level order traversal is stored in the `levelOrderTraversal` and `levelOrderTraversalSorted` member variables.
-     *
-     * @param startingNode starting node of the graph.
+     * Moves the adjacency lists into one CSR block and releases them.
+     * Neighbor order, and therefore every traversal order, is unchanged.
      */
-    void calculateLevelOrderTraversal(int startingNode) {
-        queue<pair<int, int>> q;                             // node and depth
-        vector<bool> visited(this->adj_list.size(), false);  // visited nodes
+    void compressAdjacency() {
+        if (not csr.empty())
+            return;
 
-        q.push({startingNode, 0});
-        visited[startingNode] = true;
+        csr = CSRAdjacency(maxNodes, edges);
+        adj_list = vector<vector<int>>();
+    }
 
-        while (!q.empty()) {
-            pair<int, int> front = q.front();
-            int node = front.first;
-            int depth = front.second;
+    /**
+     * Rebuilds the adjacency lists from the edge list and drops the CSR adjacency.
+     */
+    void expandAdjacency() {
+        // a graph made over a ready adjacency has no edge list, every edge is listed from its smaller end
+        if (edges.empty() and not csr.empty()) {
+            for (int v = 0; v <= maxNodes; v++) {
+                for (int nbr : csr[v])
+                    if (v < nbr)
+                        edges.push_back({v, nbr});
+            }
+        }
 
-            q.pop();
+        adj_list.assign(maxNodes + 1, vector<int>());
+        for (auto &edge : edges) {
+            adj_list[edge.first].push_back(edge.second);
+            adj_list[edge.second].push_back(edge.first);
+        }
 
-            if (depth >= (int)this->levelOrderTraversal.size()) {
-                vector<int> v;
-                this->levelOrderTraversal.push_back(v);
-            }
+        csr.clear();
+    }
 
-            this->levelOrderTraversal[depth].push_back(node);
+    friend std::ostream &operator<<(std::ostream &, Graph &);
 
-            for (auto nbr : adj_list[node]) {
-                if (!visited[nbr]) {
-                    q.push({nbr, depth + 1});
-                    visited[nbr] = true;
-                }
-            }
-        }
+    /**
+     * Calculates the level order traversal of the tree starting from the given root node.
+     * The level order traversal is stored in the `levelOrderTraversal` member variable, one flat
+     * node array split by level offsets, replacing the levels of any earlier call.
+     *
+     * @param startingNode starting node of the graph.
+     */
+    void calculateLevelOrderTraversal(int startingNode) {
+        levelOrderTraversal.build(maxNodes, startingNode, workspace, [this](int node) { return neighbors(node); });
     }
 
     bool checkIfThisLevelIsPossibleToColorWithColorOne(int level_id, vector<bool> &levelsColoredWithColorOne) {
@@ -116,8 +222,8 @@ public:
         std::sort(
             this->levelOrderTraversalSorted.begin(),
             this->levelOrderTraversalSorted.end(),
-            [](const vector<int> &a, const vector<int> &b) {
-                return a.size() > b.size();
+            [this](int a, int b) {
+                return levelOrderTraversal[a].size() > levelOrderTraversal[b].size();
             });
 
         for (int level_id = 0; level_id < (int)this->levelOrderTraversalSorted.size(); level_id++) {
@@ -125,8 +231,8 @@ public:
             // already colored with color 1, if not color this level with color 1
             if (checkIfThisLevelIsPossibleToColorWithColorOne(level_id, levelsColoredWithColorOne)) {
                 levelsColoredWithColorOne[level_id] = true;
-                auto level = this->levelOrderTraversalSorted[level_id];
-                for (auto node : level) this->colors[node] = Color(1);
+                auto level = this->levelOrderTraversal[this->levelOrderTraversalSorted[level_id]];
+                this->colors.fill(level, 1);
             }
             // else we don't color this level with color one and
             // move on to the next possible level
@@ -147,115 +253,386 @@ public:
      * the coloring assingnment is stored in the colors vector
      */
     int approximatePackingColor(int rootNode) {
-        calculateLevelOrderTraversal(rootNode);
+        // levels loaded with a mapped graph file are used when they start at the same root
+        if (levelOrderTraversal.empty() or levelOrderTraversal.nodes[0] != rootNode)
+            calculateLevelOrderTraversal(rootNode);
         maximizeColorOne();
 
+        ballScanVisitedNodes = 0;
+        distanceOracleQueries = 0;
+
+        if (engine == PackingColorEngine::CENTROID_INDEX)
+            buildCentroidIndex(rootNode);
+        buildDistanceOracle(rootNode);
+
         // currently we are looking for colors until maxNodes explicitly
         // difficult to bound what is the maximum we should look for.
         int maxReusableColorUpperBound = this->maxNodes;
         int uniquelyUsedColors = 0;
 
+        // colors above maxReusableColorUpperBound are never reused,
+        // such a candidate is counted as a uniquely colored node.
+        int lastExploredColor = std::min(maxReusableColorUpperBound, this->maxNodes - 1);
+
+        // the team is only started when levels can be split, parallel coloring validates with the distance oracle
+        bool isParallel = coloringThreads > 1 and not distanceOracle.empty();
+        ThreadTeam team(isParallel ? coloringThreads : 1);
+        // O(maxNodes) per thread, so it is allocated once, by the first level colored in parallel
+        vector<ColoringThreadScratch> scratch;
+
         for (int level = this->levelOrderTraversal.size() - 1; level >= 0; level--) {
-            vector<int> thisLevel = levelOrderTraversal[level];
+            std::span<const int> thisLevel = levelOrderTraversal[level];
             // if any node in this layer is colored with
             // color 1 that means the whole layer is colored with color 1
             // so we can skip this layer
-            if (this->colors[thisLevel[0]] == Color(1))
+            if (this->colors[thisLevel[0]] == 1)
                 continue;  // level already colored with color 1, move on
 
+            // a candidate only colors itself, so the uncolored ones can be listed up front
+            vector<int> candidates;
             for (auto candidate : thisLevel) {
-                if (colors[candidate] != Color(0))
-                    continue;  // node already colored, move on
-                // we need to color this candidate.
-                // for each node do a bfs to find if it is colorable with color = color
-                int currentlyExploringColor = 1;
+                if (colors[candidate] == 0)
+                    candidates.push_back(candidate);
+            }
 
-                set<int> colorsFoundWhileTravelling;
+            vector<int> levelColors;
+            if (isParallel and (int)candidates.size() >= PARALLEL_COLORING_MIN_CANDIDATES) {
+                if (scratch.empty()) {
+                    scratch.reserve(team.size());
+                    for (int id = 0; id < team.size(); id++) scratch.emplace_back(maxNodes);
+                }
+                levelColors = colorCandidatesInParallel(candidates, lastExploredColor, team, scratch);
+            } else
+                levelColors = colorCandidates(candidates, lastExploredColor);
 
-                while (currentlyExploringColor < maxNodes) {
-                    // from color = 2 to color = MaxNodes
-                    // check if it is possible to color with this node
+            if (lastExploredColor == maxReusableColorUpperBound)
+                uniquelyUsedColors += std::count(levelColors.begin(), levelColors.end(), 0);
+        }
 
-                    // cout << "[CANDIDATE]: " << candidate << " currentlyExploringColor = " << currentlyExploringColor << endl;
+        releaseDistanceOracle();
+        centroidIndex.clear();
 
-                    if (colorsFoundWhileTravelling.count(currentlyExploringColor) == 0) {
-                        colorsFoundWhileTravelling = travelForColor(Color(currentlyExploringColor), candidate);
+        return uniquelyUsedColors;  // colors used once
+    }
 
-                        // cout << "calling again for currentlyExploringColor = " << currentlyExploringColor << endl;
+    /**
+     * Colors candidates one after the other, each seeing the colors of those before it.
+     *
+     * @param candidates The uncolored nodes of a level, in coloring order.
+     * @param lastExploredColor The largest color that may be assigned.
+     * @return The color given to each candidate, 0 where no color fits.
+     */
+    vector<int> colorCandidates(const vector<int> &candidates, int lastExploredColor) {
+        vector<int> assigned(candidates.size(), 0);
+
+        for (size_t i = 0; i < candidates.size(); i++) {
+            int candidate = candidates[i];
+            int color = centroidIndex.empty()
+                            ? ballScanForColor(candidate, lastExploredColor)
+                            : centroidScanForColor(candidate, lastExploredColor);
+
+            if (color != 0)
+                assignColor(candidate, color);
+            assigned[i] = color;
+        }
 
-                        // if we don't find the current color then we color it with
-                        // currentlyExploringColor and gtfo
-                        if (colorsFoundWhileTravelling.count(currentlyExploringColor) == 0) {
-                            // cout << "*************" << endl;
-                            // for (auto i : colorsFoundWhileTravelling) { cout << i << " ";}
-                            // cout << "\n*************" << endl;
+        return assigned;
+    }
 
-                            colors[candidate] = currentlyExploringColor;
-                            break;
-                        }
+    /**
+     * @brief Colors the candidates of one level on several threads, exactly as colorCandidates would.
+     *
+     * Candidates are taken in chunks. All threads first compute, for every candidate of a chunk,
+     * the smallest color that fits against the colors assigned before the chunk, nothing is written
+     * meanwhile. The chunk is then committed in order: colors are only ever added, so the
+     * sequential color of a candidate is never below its speculative color s, and it equals s
+     * unless an earlier candidate of the same chunk took s within distance s. Two nodes of one
+     * level are at distance 2h where h is the height of their lowest common ancestor, so that
+     * happens exactly when both share the ancestor s / 2 levels up; such a candidate is searched
+     * again sequentially. Color 1 never conflicts, nodes of a level are not adjacent.
+     *
+     * @param candidates The uncolored nodes of a level, in coloring order.
+     * @param lastExploredColor The largest color that may be assigned.
+     * @param team The threads to search with.
+     * @param scratch One entry per thread of team, reused across the levels of a coloring.
+     * @return The color given to each candidate, 0 where no color fits.
+     */
+    vector<int> colorCandidatesInParallel(const vector<int> &candidates, int lastExploredColor, ThreadTeam &team,
+                                          vector<ColoringThreadScratch> &scratch) {
+        vector<int> assigned(candidates.size(), 0);
+        unordered_set<uint64_t> takenNearAncestor;  // (ancestor, color) of the candidates committed in this chunk
+        auto keyOf = [this](int node, int color) {
+            return (uint64_t)(uint32_t)distanceOracle.ancestor(node, color / 2) << 32 | (uint32_t)color;
+        };
+
+        size_t chunkSize = (size_t)team.size() * PARALLEL_COLORING_CHUNK_PER_THREAD;
+        for (size_t begin = 0; begin < candidates.size(); begin += chunkSize) {
+            size_t end = std::min(candidates.size(), begin + chunkSize);
+
+            // speculate: read only, every thread searches with its own scratch
+            std::atomic<size_t> next(begin);
+            team.run([&](int id) {
+                ColoringThreadScratch &own = scratch[id];
+                for (size_t from; (from = next.fetch_add(64)) < end;) {
+                    for (size_t i = from; i < std::min(end, from + 64); i++) {
+                        assigned[i] = centroidIndex.empty()
+                                          ? ballScanForColor(candidates[i], lastExploredColor, own.workspace,
+                                                             own.colorsWithinRadius, own.visitedNodes, own.oracleQueries)
+                                          : centroidScanForColor(candidates[i], lastExploredColor);
                     }
+                }
+            });
+
+            // commit in order, redoing the candidates whose color was taken nearby within the chunk
+            takenNearAncestor.clear();
+            for (size_t i = begin; i < end; i++) {
+                int candidate = candidates[i], color = assigned[i];
+                if (color == 0)
+                    continue;  // nothing fitted before the chunk, nothing fits after it
+
+                if (color > 1 and takenNearAncestor.count(keyOf(candidate, color))) {
+                    // colors up to the speculative one are taken, the smaller ones were before the chunk
+                    color = centroidIndex.empty()
+                                ? ballScanForColor(candidate, lastExploredColor, workspace, colorsWithinRadius,
+                                                   ballScanVisitedNodes, distanceOracleQueries, color + 1)
+                                : centroidScanForColor(candidate, lastExploredColor, color + 1);
+                    assigned[i] = color;
+                    if (color == 0)
+                        continue;
+                }
+
+                assignColor(candidate, color);
+                if (color > 1)
+                    takenNearAncestor.insert(keyOf(candidate, color));
+            }
+        }
+
+        for (auto &own : scratch) {
+            ballScanVisitedNodes += own.visitedNodes;
+            distanceOracleQueries += own.oracleQueries;
+            own.visitedNodes = own.oracleQueries = 0;
+        }
+
+        return assigned;
+    }
+
+    /**
+     * Indexes the tree rooted at rootNode for O(1) distance queries and lists the current
+     * holders of every color. Nothing is built when neither the ball scan nor parallel
+     * coloring needs it, or when the component of the root is not a tree.
+     *
+     * @param rootNode The root of the tree being colored.
+     */
+    void buildDistanceOracle(int rootNode) {
+        bool isUsedByBallScan = engine == PackingColorEngine::BALL_SCAN and distanceOracleHolderLimit > 0;
+        if (not isUsedByBallScan and coloringThreads <= 1)
+            return;
+        if (not distanceOracle.build(maxNodes, rootNode, [this](int node) { return neighbors(node); }))
+            return;
+
+        nodesWithColor.clear();
+        for (int node = 1; node <= maxNodes; node++) {
+            if (colors[node] > 0)
+                recordColorHolder(node, colors[node]);
+        }
+    }
+
+    /**
+     * Decomposes the tree rooted at rootNode and marks every colored node in it.
+     * Nothing is built when the component of the root is not a tree, the ball scan is used then.
+     *
+     * @param rootNode The root of the tree being colored.
+     */
+    void buildCentroidIndex(int rootNode) {
+        if (not centroidIndex.build(maxNodes, rootNode, [this](int node) { return neighbors(node); }))
+            return;
+
+        for (int node = 1; node <= maxNodes; node++) {
+            if (colors[node] > 0)
+                centroidIndex.mark(node, colors[node]);
+        }
+    }
+
+    void releaseDistanceOracle() {
+        distanceOracle.clear();
+        nodesWithColor = vector<vector<int>>();
+    }
+
+    /**
+     * Colors a node and records it in whichever index approximatePackingColor is using.
+     */
+    void assignColor(int node, int color) {
+        colors.set(node, color);
+        if (not distanceOracle.empty())
+            recordColorHolder(node, color);
+        if (not centroidIndex.empty())
+            centroidIndex.mark(node, color);
+    }
+
+    void recordColorHolder(int node, int color) {
+        if (color >= (int)nodesWithColor.size())
+            nodesWithColor.resize(color + 1);
+        nodesWithColor[color].push_back(node);
+    }
+
+    /**
+     * True if color is rare enough to be checked against its holders with the distance oracle.
+     */
+    bool isCheckedByDistanceOracle(int color) const {
+        if (distanceOracle.empty() or distanceOracleHolderLimit <= 0)
+            return false;
+        return color >= (int)nodesWithColor.size() or (int)nodesWithColor[color].size() <= distanceOracleHolderLimit;
+    }
+
+    /**
+     * True if some node holding color lies within distance radius of node, asked to the distance oracle.
+     */
+    bool isColorHeldWithin(int node, int color, int radius, long long &oracleQueries) const {
+        if (color >= (int)nodesWithColor.size())
+            return false;
+
+        for (int holder : nodesWithColor[color]) {
+            oracleQueries++;
+            if (distanceOracle.distance(node, holder) <= radius)
+                return true;
+        }
+        return false;
+    }
 
-                    // if it is found this means we found the currentlyExploringColor
-                    // at a distance lower than the (int) currentlyExploringColor.
-                    currentlyExploringColor++;
+    /**
+     * @brief Finds the smallest color a candidate can take using one bounded BFS.
+     *
+     * The ball around the candidate is grown one BFS layer at a time and every color found is
+     * marked in `colorsWithinRadius`. The candidate takes the smallest color c whose nearest
+     * distance is greater than c, so color c is decided once the ball has radius c: it is
+     * packable if it is still absent. Colors already present at a smaller radius are skipped
+     * with a word-level scan of the bitmap. This matches calling travelForColor once per color,
+     * but every node of the final ball is visited exactly once.
+     *
+     * While approximatePackingColor runs, colors held by only a few nodes are instead decided
+     * by asking the distance oracle how far those holders are, so the ball stops growing at
+     * the radius of the last common color.
+     *
+     * @param candidate The node to be colored.
+     * @param lastExploredColor The largest color that may be assigned.
+     * @return The smallest packable color, or 0 if no color in [1, lastExploredColor] fits.
+     */
+    int ballScanForColor(int candidate, int lastExploredColor) {
+        return ballScanForColor(candidate, lastExploredColor, workspace, colorsWithinRadius,
+                                ballScanVisitedNodes, distanceOracleQueries);
+    }
 
-                    if (currentlyExploringColor > maxReusableColorUpperBound) {
-                        uniquelyUsedColors++;
-                        break;
+    /**
+     * Same as ballScanForColor(candidate, lastExploredColor) in caller owned scratch memory, without
+     * writing to the graph, so threads with their own scratch may search concurrently.
+     * Colors below firstColor must already be known not to fit, they are not checked again.
+     */
+    int ballScanForColor(int candidate, int lastExploredColor, TraversalWorkspace &bfs,
+                         ColorPresenceBitmap &seenColors, long long &visitedNodes,
+                         long long &oracleQueries, int firstColor = 1) const {
+        seenColors.clear();
+
+        bfs.beginTraversal();
+        bfs.visit(candidate);
+        bfs.push(candidate, 0);
+        seenColors.insert(colors[candidate]);
+
+        int color = seenColors.firstAbsentFrom(firstColor);
+        while (color <= lastExploredColor) {
+            bool isBlocked;
+
+            if (isCheckedByDistanceOracle(color)) {
+                // few nodes hold this color, asking for their distances is
+                // cheaper than growing the ball to radius color
+                isBlocked = isColorHeldWithin(candidate, color, color, oracleQueries);
+            } else {
+                // grow the ball until it holds every node within distance color,
+                // i.e. expand every queued node that is closer than color
+                while (not bfs.empty() and bfs.front().second < color) {
+                    auto [node, distance] = bfs.front();
+                    bfs.pop();
+
+                    for (auto nbr : neighbors(node)) {
+                        if (bfs.visit(nbr)) {
+                            bfs.push(nbr, distance + 1);
+                            seenColors.insert(colors[nbr]);
+                            visitedNodes++;
+                        }
                     }
                 }
+
+                isBlocked = seenColors.test(color);
             }
+
+            if (not isBlocked)
+                return color;
+
+            // colors present now were met within radius color, below their own ID
+            color = seenColors.firstAbsentFrom(color + 1);
         }
 
-        return uniquelyUsedColors;  // colors used once
+        return 0;
+    }
+
+    /**
+     * @brief Finds the smallest color a candidate can take by asking the centroid index.
+     *
+     * Color c fits when the nearest node already holding c is farther than c, which the
+     * centroid index answers in O(log n) without exploring the neighborhood.
+     *
+     * @param candidate The node to be colored.
+     * @param lastExploredColor The largest color that may be assigned.
+     * @param firstColor The first color to check, smaller ones are known not to fit.
+     * @return The smallest packable color, or 0 if no color in [firstColor, lastExploredColor] fits.
+     */
+    int centroidScanForColor(int candidate, int lastExploredColor, int firstColor = 1) const {
+        for (int color = firstColor; color <= lastExploredColor; color++) {
+            if (not centroidIndex.isMarkedWithin(candidate, color, color))
+                return color;
+        }
+        return 0;
     }
 
     /**
      * @brief Finds the set of colors encountered while traveling a certain distance in the graph from a given node.
      *
      * This function performs a breadth-first search (BFS) starting from the given node and travels a distance equal to the color ID of the specified color.
-     * It keeps track of the colors encountered during the traversal and returns them as a set.
+     * It keeps track of the colors encountered during the traversal in the `colorsWithinRadius` bitmap and returns it.
+     * The BFS runs in the graph's workspace, so a call only costs the size of the ball it explores.
      *
      * @param clr The color to be traveled to.
      * @param node The starting node for the traversal.
-     * @return A set of color IDs encountered while traveling to the specified color.
+     * @return The color IDs encountered while traveling to the specified color, valid until the next traversal.
      */
-    set<int> travelForColor(Color clr, int __node) {
+    const ColorPresenceBitmap &travelForColor(Color clr, int __node) {
         // to color the node with Color clr, we travel to clr distance in the
         // graph by BFS
-        int distance = 0;
-        queue<pair<int, int>> q;
-        q.push({__node, 0});
-
         int MAX_PERMISSIBLE_DISTANCE = clr.colorID;
 
-        set<int> colorsFoundWhileVisiting;
+        colorsWithinRadius.clear();
 
-        vector<bool> BFSVisited(this->maxNodes + 1, false);
-        BFSVisited[__node] = true;
+        workspace.beginTraversal();
+        workspace.visit(__node);
+        workspace.push(__node, 0);
 
-        while (not q.empty()) {
-            pair<int, int> front = q.front();
-            int node = front.first;
-            distance = front.second;
+        while (not workspace.empty()) {
+            auto [node, distance] = workspace.front();
+            workspace.pop();
 
-            colorsFoundWhileVisiting.insert(colors[node].colorID);
+            colorsWithinRadius.insert(colors[node]);
 
             // cout << "[VISITING] NODE: " << node << " has color [COLOR]: " << colors[node] << endl;
 
-            q.pop();
+            if (distance + 1 > MAX_PERMISSIBLE_DISTANCE)
+                continue;
 
-            for (auto nbr : adj_list[node]) {
-                if (distance + 1 <= MAX_PERMISSIBLE_DISTANCE) {
-                    if (not BFSVisited[nbr]) {
-                        q.push({nbr, distance + 1});
-                        BFSVisited[nbr] = true;
-                    }
-                }
+            for (auto nbr : neighbors(node)) {
+                if (workspace.visit(nbr))
+                    workspace.push(nbr, distance + 1);
             }
         }
 
-        return colorsFoundWhileVisiting;
+        return colorsWithinRadius;
     }
 };
 
@@ -268,11 +645,9 @@ public:
  * @return The output stream after writing the graph representation.
  */
 std::ostream &operator<<(std::ostream &stream, Graph &g) {
-    vector<vector<int>> adj_list = g.adj_list;
-    int nodes = adj_list.size();
-    for (int i = 1; i < nodes; i++) {
+    for (int i = 1; i <= g.maxNodes; i++) {
         stream << i << " -> ";
-        for (int j : adj_list[i]) {
+        for (int j : g.neighbors(i)) {
             stream << j << " ";
         }
 
@@ -309,57 +684,165 @@ void createGraphWhileLevelOrderTraversalOfEquivalentTree(Tree *root, Graph *g) {
     }
 }
 
+// the pair space of generateGnP is cut into this many ranges, each sampled from its own seed.
+// it does not depend on the thread count, so the graph of a seed is the same on any machine
+constexpr int GNP_SAMPLING_RANGES = 256;
+
 /**
- * @brief Generates an Erdos-Renyi random graph.
+ * @brief Samples the edges of G(n, p) among the pairs with linear index in [begin, end).
  *
- * This function generates an Erdos-Renyi random graph with n nodes and an optional probability p.
- * If the probability p is not given, a random probability is generated between 0 and 1 uniformly at random.
+ * Pairs (i, j), i < j, are indexed row by row as the nested loop over i and j would meet them.
+ * Instead of one draw per pair, the gap to the next edge is drawn from the geometric distribution
+ * of the number of failed Bernoulli(p) trials (Batagelj and Brandes, 2005), so the work is
+ * proportional to the edges produced.
  *
- * @param n The number of nodes in the graph.
- * @param p The probability of an edge between any two nodes (optional).
- * @return The generated random graph.
+ * @param n The number of nodes.
+ * @param p The edge probability, in (0, 1).
+ * @param begin The linear index of the first pair.
+ * @param end One past the linear index of the last pair.
+ * @param generator The generator of this range.
+ * @param emit Called with every sampled edge (i, j) in pair order, sampling stops when it returns false.
+ * @return False if emit stopped the sampling.
  */
-pair<Graph, double> generateGnP(int n, double p = 0) {
-    // set random seed for randomization of generator
-    srand(time(0));
+template <typename EdgeSink>
+bool sampleGnPRange(int n, double p, long long begin, long long end, std::mt19937 &generator, EdgeSink &&emit) {
+    std::uniform_real_distribution<double> urdist(0.0, 1.0);
+    double logOfMiss = std::log1p(-p);
+
+    // row i holds the n - i pairs (i, i + 1) .. (i, n) and starts at index (i - 1) n - i (i - 1) / 2,
+    // binary search the row of begin
+    auto rowStart = [n](long long row) { return (row - 1) * n - row * (row - 1) / 2; };
+    long long low = 1, high = n - 1;
+    while (low < high) {
+        long long mid = (low + high + 1) / 2;
+        if (rowStart(mid) <= begin)
+            low = mid;
+        else
+            high = mid - 1;
+    }
+    long long i = low, j = i + 1 + (begin - rowStart(i));
+
+    // (i, j) is the pair at index, the next candidate is `pending` pairs further
+    long long index = begin, pending = 0;
+    while (true) {
+        // number of pairs missed before the next edge
+        double misses = std::floor(std::log1p(-urdist(generator)) / logOfMiss);
+        if (misses >= (double)(end - index - pending))
+            return true;
 
-    if (p == 0) {
-        // This means that the probability is not given.
-        // So we will generate a random probability.
-        int probability_lower_bound = 0;
-        int probability_upper_bound = 100;
+        long long step = pending + (long long)misses;
+        index += step;
+        j += step;
+        while (j > n) {
+            // wrap into the next row, which starts at column i + 2
+            long long excess = j - n;
+            i++;
+            j = i + excess;
+        }
 
-        std::random_device randomDevice;
-        std::mt19937 generator(randomDevice());
+        if (not emit((int)i, (int)j))
+            return false;
+        pending = 1;
+    }
+}
 
-        std::uniform_int_distribution<int> distribution(probability_lower_bound, probability_upper_bound);
+/**
+ * @brief Draws the probability of a G(n, p) graph whose probability is not given,
+ * uniformly among 0, 0.01 .. 0.99.
+ */
+double drawEdgeProbability(std::mt19937 &generator) {
+    // This means that the probability is not given.
+    // So we will generate a random probability.
+    int probability_lower_bound = 0;
+    int probability_upper_bound = 100;
 
-        int random_probability = distribution(generator);
-        p = static_cast<double>(random_probability % 100) / 100;
-    }
+    std::uniform_int_distribution<int> distribution(probability_lower_bound, probability_upper_bound);
 
-    // Create a graph with n nodes.
-    Graph G(n);
+    int random_probability = distribution(generator);
+    return static_cast<double>(random_probability % 100) / 100;
+}
+
+/**
+ * @brief Generates an Erdos-Renyi random graph from the given generator.
+ *
+ * The pair space is split into GNP_SAMPLING_RANGES ranges sampled with geometric skips, in
+ * O(n + m) time instead of one draw per pair. Range r is seeded with a seed drawn from the given
+ * generator and r, so the graph only depends on the generator state and not on `threads`, and
+ * generators seeded per test case may be used from several threads at once.
+ *
+ * @param n The number of nodes in the graph.
+ * @param p The probability of an edge between any two nodes, 0 draws one uniformly at random.
+ * @param generator The random number generator to draw from.
+ * @param threads The threads sampling ranges concurrently.
+ * @return The generated random graph and its probability.
+ */
+pair<Graph, double> generateGnP(int n, double p, std::mt19937 &generator, int threads = 1) {
+    if (p == 0)
+        p = drawEdgeProbability(generator);
 
     // we add each possible edge with probability p.
     // edges are un-directed, thereby considered only once.
-    std::random_device randomDevice;
-    std::mt19937 generator(randomDevice());  // mt19937 is a standard mersenne_twister_engine
-    std::uniform_real_distribution<double> urdist(0.0, 1.0);
+    long long pairs = (long long)n * (n - 1) / 2;
+    unsigned seed = generator();
+    vector<vector<pair<int, int>>> rangeEdges(GNP_SAMPLING_RANGES);
+
+    if (p >= 1) {
+        rangeEdges[0].reserve(pairs);
+        for (int i = 1; i <= n; i++) {
+            for (int j = i + 1; j <= n; j++) rangeEdges[0].push_back({i, j});
+        }
+    } else if (p > 0 and pairs > 0) {
+        std::atomic<int> nextRange(0);
+        ThreadTeam team(std::min(threads, GNP_SAMPLING_RANGES));
+
+        team.run([&](int) {
+            for (int range; (range = nextRange++) < GNP_SAMPLING_RANGES;) {
+                long long begin = pairs * range / GNP_SAMPLING_RANGES;
+                long long end = pairs * (range + 1) / GNP_SAMPLING_RANGES;
+                if (begin == end)
+                    continue;
+
+                std::seed_seq rangeSeed{seed, (unsigned)range};
+                std::mt19937 rangeGenerator(rangeSeed);
+                rangeEdges[range].reserve((size_t)((end - begin) * p * 1.1) + 16);
+                auto &edges = rangeEdges[range];
+                sampleGnPRange(n, p, begin, end, rangeGenerator, [&edges](int i, int j) {
+                    edges.push_back({i, j});
+                    return true;
+                });
+            }
+        });
+    }
 
-    for (int i = 1; i <= n; i++) {
-        for (int j = i + 1; j <= n; j++) {
-            // generate a random number between 0 and 1.
-            double random_number = urdist(generator);
+    size_t total = 0;
+    for (auto &edges : rangeEdges) total += edges.size();
 
-            if (random_number <= p) {
-                // add edge between i and j.
-                G.add_edge(i, j);
-            }
-        }
+    vector<pair<int, int>> edges;
+    edges.reserve(total);
+    for (auto &range : rangeEdges) {
+        edges.insert(edges.end(), range.begin(), range.end());
+        range = vector<pair<int, int>>();
     }
 
-    return {G, p};
+    // Create a graph with n nodes.
+    return {Graph(n, std::move(edges)), p};
+}
+
+/**
+ * @brief Generates an Erdos-Renyi random graph.
+ *
+ * This function generates an Erdos-Renyi random graph with n nodes and an optional probability p.
+ * If the probability p is not given, a random probability is generated between 0 and 1 uniformly at random.
+ *
+ * @param n The number of nodes in the graph.
+ * @param p The probability of an edge between any two nodes (optional).
+ * @return The generated random graph.
+ */
+pair<Graph, double> generateGnP(int n, double p = 0) {
+    std::random_device randomDevice;
+    std::mt19937 generator(randomDevice());  // mt19937 is a standard mersenne_twister_engine
+
+    return generateGnP(n, p, generator);
 }
 
 /**
@@ -374,11 +857,9 @@ Graph generateMST(Graph &G) {
     // create a disjoint set.
     DisjointSet ds(G.maxNodes);
 
-    // create a graph with same number of nodes.
-    Graph MST(G.maxNodes);
-
-    // create a vector of edges.
+    // collect the edges of the MST.
     vector<pair<int, int>> edges;
+    edges.reserve(G.maxNodes > 0 ? G.maxNodes - 1 : 0);
 
     // iterate over all edges.
     for (auto edge : G.edges) {
@@ -387,11 +868,108 @@ Graph generateMST(Graph &G) {
 
         // if the edge does not form a cycle, add it to the MST.
         if (ds.Union(from, to)) {
-            MST.add_edge(from, to);
+            edges.push_back(edge);
+        }
+    }
+
+    // the MST is built once, straight into CSR adjacency.
+    return Graph(G.maxNodes, std::move(edges));
+}
+
+/**
+ * @brief Generates the spanning forest generateMST(G) returns, on several threads.
+ *
+ * Every thread takes a contiguous slice of G.edges and runs Kruskal on that slice alone with its
+ * own DisjointSet, keeping the slice's spanning forest. An edge dropped there closes a cycle with
+ * earlier edges of its slice, so sequential Kruskal drops it too, and each slice forest connects
+ * exactly what its whole slice does. Kruskal over the slice forests in slice order therefore keeps
+ * the same edges as over all of G.edges: the tree does not depend on the thread schedule.
+ * Each thread holds O(maxNodes) memory for its DisjointSet.
+ *
+ * @param G The orignal graph that may contain cycle.
+ * @param threads The threads filtering slices concurrently.
+ * @return Once MST of the graph, the same edges in the same order as generateMST(G).
+ */
+Graph generateMST(Graph &G, int threads) {
+    if (threads <= 1)
+        return generateMST(G);
+
+    ThreadTeam team(threads);
+    vector<vector<pair<int, int>>> sliceEdges(team.size());
+
+    team.run([&](int id) {
+        size_t begin = G.edges.size() * id / team.size();
+        size_t end = G.edges.size() * (id + 1) / team.size();
+
+        DisjointSet slice(G.maxNodes);
+        for (size_t e = begin; e < end; e++) {
+            if (slice.Union(G.edges[e].first, G.edges[e].second))
+                sliceEdges[id].push_back(G.edges[e]);
+        }
+    });
+
+    DisjointSet ds(G.maxNodes);
+    vector<pair<int, int>> edges;
+    edges.reserve(G.maxNodes > 0 ? G.maxNodes - 1 : 0);
+    for (auto &slice : sliceEdges) {
+        for (auto edge : slice) {
+            if (ds.Union(edge.first, edge.second))
+                edges.push_back(edge);
+        }
+        slice = vector<pair<int, int>>();
+    }
+
+    return Graph(G.maxNodes, std::move(edges));
+}
+
+/**
+ * @brief Generates the spanning forest generateMST(generateGnP(n, p, generator).first) would
+ * return, without ever storing the G(n, p) graph.
+ *
+ * The ranges of generateGnP are sampled in order from the same seeds, and every sampled edge
+ * goes straight into DisjointSet::Union, only tree edges are kept. Sampling stops once the
+ * tree spans all n nodes, later edges could only close cycles. Memory is O(n) instead of the
+ * O(n log n) edges stored in the adjacency lists, the edge list and the returned copy.
+ *
+ * @param n The number of nodes in the graph.
+ * @param p The probability of an edge between any two nodes, 0 draws one uniformly at random.
+ * @param generator The random number generator to draw from.
+ * @return The spanning forest, in CSR form, and the probability.
+ */
+pair<Graph, double> generateGnPSpanningTree(int n, double p, std::mt19937 &generator) {
+    if (p == 0)
+        p = drawEdgeProbability(generator);
+
+    long long pairs = (long long)n * (n - 1) / 2, treeEdges = std::max(n - 1, 0);
+    unsigned seed = generator();
+
+    DisjointSet ds(n);
+    vector<pair<int, int>> edges;
+    edges.reserve(treeEdges);
+
+    auto span = [&](int from, int to) {
+        if (ds.Union(from, to))
+            edges.push_back({from, to});
+        return (long long)edges.size() < treeEdges;
+    };
+
+    if (p >= 1) {
+        // every pair is an edge, the first row (1, j) already spans the graph
+        for (int j = 2; j <= n; j++) span(1, j);
+    } else if (p > 0 and pairs > 0) {
+        for (int range = 0; range < GNP_SAMPLING_RANGES and (long long)edges.size() < treeEdges; range++) {
+            long long begin = pairs * range / GNP_SAMPLING_RANGES;
+            long long end = pairs * (range + 1) / GNP_SAMPLING_RANGES;
+            if (begin == end)
+                continue;
+
+            std::seed_seq rangeSeed{seed, (unsigned)range};
+            std::mt19937 rangeGenerator(rangeSeed);
+            sampleGnPRange(n, p, begin, end, rangeGenerator, span);
         }
     }
 
-    return MST;
+    return {Graph(n, std::move(edges)), p};
 }
 
 int computeDiamterOfArbitaryRootedTree(Graph &g, int rootID) {
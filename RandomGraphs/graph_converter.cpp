@@ -0,0 +1,36 @@
+#include <iostream>
+#include <string>
+
+#include "edge_archive.hpp"
+#include "mapped_graph.hpp"
+
+/**
+ * Converts text edge files of generatedgraphs/ to mapped graph files, or to edge archives
+ * when the output ends in .pea.
+ * usage: ./convert <edges.txt> [graph.csr | edges.pea] [root]
+ * the output defaults to the input with a .csr extension, the root to the tree center.
+ */
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        std::cout << "usage: " << argv[0] << " <edges.txt> [graph.csr | edges.pea] [root]" << std::endl;
+        return 1;
+    }
+
+    std::string textPath = argv[1];
+    size_t extension = textPath.find_last_of('.'), directory = textPath.find_last_of('/');
+    bool hasExtension = extension != std::string::npos and (directory == std::string::npos or extension > directory);
+    std::string binaryPath = argc > 2 ? argv[2] : textPath.substr(0, hasExtension ? extension : textPath.size()) + ".csr";
+    int root = argc > 3 ? std::stoi(argv[3]) : 0;
+
+    bool isArchive = binaryPath.size() >= 4 and binaryPath.compare(binaryPath.size() - 4, 4, ".pea") == 0;
+    bool converted = isArchive ? EdgeArchive::convertEdgeFile(textPath, binaryPath)
+                               : MappedGraph::convertEdgeFile(textPath, binaryPath, root);
+
+    if (not converted) {
+        std::cout << "Error converting " << textPath << std::endl;
+        return 1;
+    }
+
+    std::cout << textPath << " -> " << binaryPath << std::endl;
+    return 0;
+}
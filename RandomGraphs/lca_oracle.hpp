@@ -0,0 +1,144 @@
+#if !defined(LCA_ORACLE)
+#define LCA_ORACLE
+
+#include <bit>
+#include <climits>
+#include <utility>
+#include <vector>
+
+/**
+ * @class LCADistanceOracle
+ * @brief Answers tree distances in O(1) with an Euler tour and a sparse table of lowest common ancestors.
+ *
+ * The tree is rooted and walked once in DFS order. For two nodes u, v with tin[u] < tin[v]
+ * the lowest common ancestor is the parent of the shallowest node in the DFS order range
+ * (tin[u], tin[v]], so a sparse table over that order (n log n entries instead of the 2n log n
+ * of the full Euler sequence) answers every query with two lookups.
+ *
+ * Only the component of the root is indexed, nodes outside it are infinitely far away.
+ */
+class LCADistanceOracle {
+public:
+    LCADistanceOracle() = default;
+
+    /**
+     * @brief Indexes the tree that contains `root`.
+     *
+     * @param n The largest node ID.
+     * @param root The root of the tree.
+     * @param neighbors Callable returning the neighbors of a node as an iterable range.
+     * @return False if the component of the root contains a cycle, the oracle is then left empty.
+     */
+    template <typename Neighbors>
+    bool build(int n, int root, Neighbors &&neighbors) {
+        clear();
+        depth.assign(n + 1, -1);
+        parent.assign(n + 1, 0);
+        tin.assign(n + 1, -1);
+        order.reserve(n);
+
+        // iterative DFS, deep MSTs would overflow the call stack
+        long long endpoints = 0;
+        std::vector<int> stack = {root};
+        depth[root] = 0;
+        parent[root] = root;
+
+        while (not stack.empty()) {
+            int node = stack.back();
+            stack.pop_back();
+
+            tin[node] = order.size();
+            order.push_back(node);
+
+            for (int nbr : neighbors(node)) {
+                endpoints++;
+                if (depth[nbr] == -1) {
+                    depth[nbr] = depth[node] + 1;
+                    parent[nbr] = node;
+                    stack.push_back(nbr);
+                }
+            }
+        }
+
+        if (endpoints / 2 != (long long)order.size() - 1) {
+            clear();
+            return false;
+        }
+
+        buildSparseTable();
+        return true;
+    }
+
+    /**
+     * @brief Lowest common ancestor of two indexed nodes.
+     */
+    int lca(int u, int v) const {
+        if (u == v)
+            return u;
+
+        int l = tin[u], r = tin[v];
+        if (l > r)
+            std::swap(l, r);
+
+        // shallowest node in DFS order positions (l, r]
+        l++;
+        int k = std::bit_width((unsigned)(r - l + 1)) - 1;
+        int a = table[k][l], b = table[k][r - (1 << k) + 1];
+
+        return parent[depth[a] < depth[b] ? a : b];
+    }
+
+    /**
+     * @brief Number of edges on the tree path between u and v, INT_MAX if either is not indexed.
+     */
+    int distance(int u, int v) const {
+        if (tin[u] == -1 or tin[v] == -1)
+            return INT_MAX;
+        return depth[u] + depth[v] - 2 * depth[lca(u, v)];
+    }
+
+    /**
+     * @brief The ancestor `height` levels above an indexed node v, the root if v is not that deep.
+     */
+    int ancestor(int v, int height) const {
+        while (height-- > 0 and parent[v] != v) v = parent[v];
+        return v;
+    }
+
+    bool empty() const {
+        return order.empty();
+    }
+
+    void clear() {
+        depth.clear();
+        parent.clear();
+        tin.clear();
+        order.clear();
+        table.clear();
+    }
+
+private:
+    std::vector<int> depth, parent, tin;  // per node
+    std::vector<int> order;               // nodes in DFS order
+    std::vector<std::vector<int>> table;  // table[k][i]: shallowest node of order[i .. i + 2^k)
+
+    void buildSparseTable() {
+        int size = order.size();
+        int levels = std::bit_width((unsigned)size);
+
+        table.assign(levels, std::vector<int>());
+        table[0] = order;
+
+        for (int k = 1; k < levels; k++) {
+            int span = 1 << k, half = span >> 1;
+            table[k].resize(size - span + 1);
+
+            for (int i = 0; i + span <= size; i++) {
+                int a = table[k - 1][i], b = table[k - 1][i + half];
+                table[k][i] = depth[a] < depth[b] ? a : b;
+            }
+        }
+    }
+};
+
+#endif  // LCA_ORACLE
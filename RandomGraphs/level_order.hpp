@@ -0,0 +1,78 @@
+#if !defined(LEVEL_ORDER)
+#define LEVEL_ORDER
+
+#include <span>
+#include <vector>
+
+#include "traversal_workspace.hpp"
+
+/**
+ * @class LevelOrder
+ * @brief The nodes reachable from a root grouped by their BFS depth, in two flat arrays.
+ *
+ * The nodes at depth d are nodes[offsets[d] .. offsets[d + 1]). Nodes are stored in the
+ * order the BFS dequeues them, which is already grouped by depth, so the node array doubles
+ * as the BFS queue and building costs one pass and no allocation per level.
+ */
+class LevelOrder {
+public:
+    std::vector<int> nodes;    // every reached node, level after level
+    std::vector<int> offsets;  // levels + 1 entries
+
+    LevelOrder() = default;
+
+    /**
+     * @brief Replaces the levels with those of a BFS from root.
+     *
+     * @param n The largest node ID.
+     * @param root The node at depth 0.
+     * @param bfs Workspace whose visited marks the traversal uses.
+     * @param neighbors Callable returning the neighbors of a node.
+     */
+    template <typename Neighbors>
+    void build(int n, int root, TraversalWorkspace &bfs, Neighbors &&neighbors) {
+        nodes.clear();
+        nodes.reserve(n);
+        offsets.assign(1, 0);
+
+        bfs.beginTraversal();
+        bfs.visit(root);
+        nodes.push_back(root);
+
+        // nodes[levelBegin .. levelEnd) is the deepest complete level, its children are appended after it
+        for (size_t levelBegin = 0; levelBegin < nodes.size();) {
+            size_t levelEnd = nodes.size();
+            offsets.push_back(levelEnd);
+
+            for (size_t i = levelBegin; i < levelEnd; i++) {
+                for (auto nbr : neighbors(nodes[i])) {
+                    if (bfs.visit(nbr))
+                        nodes.push_back(nbr);
+                }
+            }
+            levelBegin = levelEnd;
+        }
+    }
+
+    std::span<const int> operator[](int level) const {
+        return std::span<const int>(nodes.data() + offsets[level], offsets[level + 1] - offsets[level]);
+    }
+
+    /**
+     * @brief The number of levels, the depth of the deepest node plus one.
+     */
+    int size() const {
+        return offsets.empty() ? 0 : (int)offsets.size() - 1;
+    }
+
+    bool empty() const {
+        return size() == 0;
+    }
+
+    void clear() {
+        nodes = std::vector<int>();
+        offsets = std::vector<int>();
+    }
+};
+
+#endif  // LEVEL_ORDER
@@ -10,27 +10,51 @@
 
 #include <math.h>
 #include <string.h>
+#include <sys/resource.h>
 
+#include <atomic>
 #include <chrono>
 #include <ctime>
 #include <fstream>
 #include <iomanip>
 #include <iostream>
-#include <map>
+#include <mutex>
 #include <queue>
+#include <random>
 #include <set>
 #include <sstream>
+#include <thread>
 #include <vector>
 
 #include "color.h"
+#include "edge_archive.hpp"
 #include "graph.hpp"
+#include "mapped_graph.hpp"
+#include "ordered_row_writer.hpp"
+#include "random_trees.hpp"
 #include "root_selector.cpp"
 #include "tree.h"
 
 #define FILE_CREATION_ERR "file_error"
 #define MULTIPLE_GRAPH_STATS_DIR "./stastistics/"
 #define GENERATED_GRAPHS_PATH "./generatedgraphs/"
-#define MULTIPLE_RUN_CSV_HEADER "Case ID,Number of nodes,Probability,Number of edges in MST,Selected root node,Time taken to perform the packing coloring,Maximum reusable colors used,Total colors used,Uniquely used colors,n/x ratio,1,2,One Fraction,MST Diameter"
+// true stores the MST edges as a delta + varint EdgeArchive (.pea) instead of "u v" text lines (.txt)
+#define COMPRESSED_EDGE_FILES true
+// PackingColorEngine::BALL_SCAN or PackingColorEngine::CENTROID_INDEX, both color identically
+#define PACKING_COLOR_ENGINE PackingColorEngine::BALL_SCAN
+// threads available to a run, split between concurrent test cases and the generation and coloring of each graph.
+// neither changes the results, every case draws from its own generator
+#define COLORING_THREADS std::thread::hardware_concurrency()
+// test cases run at the same time, 1 runs them one after the other
+#define PARALLEL_TEST_CASES std::thread::hardware_concurrency()
+// trees to color, RandomTreeModel::GNP_SPANNING_TREE spans a G(n,p) graph, the other models
+// generate the tree directly in O(n) and report probability 0
+#define RANDOM_TREE_MODEL RandomTreeModel::GNP_SPANNING_TREE
+// true feeds the sampled G(n,p) edges straight into the spanning tree instead of storing the graph
+#define SPAN_WHILE_GENERATING true
+// base seed of the per-case generators, 0 draws one from std::random_device
+#define RANDOM_SEED 0
+#define MULTIPLE_RUN_CSV_HEADER "Case ID,Number of nodes,Probability,Number of edges in MST,Selected root node,Time taken to perform the packing coloring,Maximum reusable colors used,Total colors used,Uniquely used colors,n/x ratio,1,2,One Fraction,MST Diameter,BFS nodes visited,Distance oracle queries,Seed,Process peak RSS so far (MB)"
 
 using namespace std;
 
@@ -56,6 +80,8 @@ void fileIO() {
  * mode. Additionally, it appends MST information to a CSV file named
  * "mst_info.csv".
  *
+ * With COMPRESSED_EDGE_FILES the edges go to an EdgeArchive, a fraction of the text size.
+ *
  * @param MST The Minimum Spanning Tree (MST) graph.
  * @return The filename (without extension) of the generated graph file.
  */
@@ -73,9 +99,14 @@ string writeMSTEdgesToAFile(Graph MST) {
     ss << std::put_time(timeInfo, "%Y%m%d_%H%M%S");
 
     // Create a file name with the current date and time
-    std::string fileName = "random_graph_" + ss.str() + ".txt";
+    std::string fileName = "random_graph_" + ss.str() + (COMPRESSED_EDGE_FILES ? ".pea" : ".txt");
     std::string filename_without_extension = "random_graph_" + ss.str();
 
+    if (COMPRESSED_EDGE_FILES) {
+        EdgeArchive::write(GENERATED_GRAPHS_PATH + fileName, MST.maxNodes, MST.edges);
+        return filename_without_extension;
+    }
+
     std::ofstream file(GENERATED_GRAPHS_PATH + fileName, std::ios::trunc);
     file.close();
 
@@ -97,7 +128,7 @@ string writeMSTEdgesToAFile(Graph MST) {
  * This function generates a random graph using the G(n,p) model, where n is the
  * number of nodes and p is the probability of an edge between any two nodes. It
  * then generates the minimum spanning tree (MST) of the random graph and writes
- * the edges of the MST to a file named "edges.txt".
+ * the edges of the MST to a file named "edges.txt" and to a mapped graph file.
  *
  * @param caseid The ID of the case to solve.
  */
@@ -117,6 +148,9 @@ pair<Graph, string> generateRandomGraph(int nodes) {
     Graph MST = GraphServices::generateMST(result.first);
     std::string filename = writeMSTEdgesToAFile(MST);
 
+    // the same tree as a mapped graph file, reloaded for re-coloring without parsing the edges
+    MappedGraph::write(GENERATED_GRAPHS_PATH + filename + ".csr", MST, RootSelector::treeCenterRootSelectionScheme(MST));
+
     std::string stat_fileName = filename + "_stats.txt";
 
     std::ofstream stat_file(GENERATED_GRAPHS_PATH + stat_fileName,
@@ -144,20 +178,25 @@ pair<Graph, string> generateRandomGraph(int nodes) {
  * It then generates the minimum spanning tree (MST) of the generated graph.
  *
  * @param nodes The number of nodes in the graph.
+ * @param generator The generator of this test case, the probability and every edge are drawn from it.
+ * @param threads The threads sampling the edges, the graph does not depend on it.
  * @return A pair containing the generated MST and the probability used for graph generation.
  */
-pair<Graph, double> generateRandomGraphWithProbability(int nodes) {
-    srand(time(0));
+pair<Graph, double> generateRandomGraphWithProbability(int nodes, std::mt19937 &generator, int threads) {
     double logn_f_n = log2(nodes) / nodes;
 
     // choose a probability uniformly at random
     // between 1 * logn_f_n and 2 * logn_f_n
-    double probability = (rand() % 100) / 100.0;
+    std::uniform_int_distribution<int> percent(0, 99);
+    double probability = percent(generator) / 100.0;
     probability = probability * logn_f_n;
     probability += logn_f_n;
 
-    auto result = GraphServices::generateGnP(nodes, probability);
-    Graph MST = GraphServices::generateMST(result.first);
+    if (SPAN_WHILE_GENERATING)
+        return GraphServices::generateGnPSpanningTree(nodes, probability, generator);
+
+    auto result = GraphServices::generateGnP(nodes, probability, generator, threads);
+    Graph MST = GraphServices::generateMST(result.first, threads);
 
     return {MST, probability};
 }
@@ -191,6 +230,8 @@ void solve(int caseid) {
 
     int PACKING_COLORING_NODE_START =
         RootSelector::treeCenterRootSelectionScheme(MST);
+    MST.engine = PACKING_COLOR_ENGINE;
+    MST.coloringThreads = COLORING_THREADS;
     auto procedure_start = std::chrono::high_resolution_clock::now();
     int uniquelyUsedColors =
         MST.approximatePackingColor(PACKING_COLORING_NODE_START);
@@ -201,24 +242,16 @@ void solve(int caseid) {
     stat_file << "⏳ " << duration.count() << " seconds"
               << "\n";
 
-    vector<Color> colors = MST.colors;
-
-    int maximumReusableColorID = -1;
-
-    map<int, int> colorCounter;
-
-    for (int i = 1; i < (int)colors.size(); i++) {
-        maximumReusableColorID =
-            std::max(colors[i].colorID, maximumReusableColorID);
-        colorCounter[colors[i].colorID]++;
-    }
+    int maximumReusableColorID = MST.colors.max();
+    vector<int> colorCounter = MST.colors.histogram();
 
     stat_file << "Maximum Reusable Colors used: " << maximumReusableColorID
               << "\n";
 
-    for (auto counter : colorCounter) {
-        stat_file << "[COLOR]: " << counter.first << " -> " << counter.second
-                  << "\n";
+    for (int color = 0; color < (int)colorCounter.size(); color++) {
+        if (colorCounter[color] > 0)
+            stat_file << "[COLOR]: " << color << " -> " << colorCounter[color]
+                      << "\n";
     }
 
     stat_file << "uniquelyUsedColors: " << uniquelyUsedColors << "\n";
@@ -231,57 +264,79 @@ void solve(int caseid) {
     stat_file.close();
 }
 
-void recordMultipleRandomGraphRuns(int caseid) {
-    int total_nodes;
-    cin >> total_nodes;
-    std::cout << "graph generation started for " << total_nodes << endl;
-    pair<Graph, double> result = generateRandomGraphWithProbability(total_nodes);
-    std::cout << "graph generation with " << total_nodes << " is complete" << endl;
-    Graph MST = result.first;
-    double probability = result.second;
+/**
+ * Largest resident set of the whole process so far in MB, not the memory of one test case.
+ * The high-water mark never drops, so a case's row includes every case that ran before it or,
+ * with PARALLEL_TEST_CASES above 1, alongside it. Only the last row bounds the run as a whole.
+ */
+double peakResidentSetMB() {
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+#if defined(__APPLE__)
+    return usage.ru_maxrss / (1024.0 * 1024.0);  // bytes
+#else
+    return usage.ru_maxrss / 1024.0;  // kilobytes
+#endif
+}
 
-    std::string stats = std::string(MULTIPLE_GRAPH_STATS_DIR) + "stats.csv";
-    std::ofstream file(stats, std::ios::app);
+/**
+ * Prints one progress line, lines of concurrent test cases are not interleaved.
+ */
+void logProgress(const std::string &line) {
+    static std::mutex outputLock;
+    std::lock_guard<std::mutex> lock(outputLock);
+    cout << line << endl;
+}
 
-    if (!file.is_open()) {
-        std::cout << "Error opening this [file] \nexiting"
-                  << endl;
-        return;
-    }
+/**
+ * Generates, spans and colors one random graph and hands its row of stats.csv to the writer.
+ * Test cases share nothing but the writer, so several may run at once.
+ *
+ * @param caseid The ID of the case, rows are written in this order.
+ * @param total_nodes The number of nodes of the random graph.
+ * @param seed The base seed of the run, the generator of a case is seeded with it and the case ID.
+ * @param threads The threads used to generate the graph and to color the MST.
+ * @param stats The writer of stats.csv.
+ */
+void recordMultipleRandomGraphRuns(int caseid, int total_nodes, unsigned seed, int threads, OrderedRowWriter &stats) {
+    std::seed_seq caseSeed{seed, (unsigned)caseid};
+    std::mt19937 generator(caseSeed);
+
+    logProgress("graph generation started for " + std::to_string(total_nodes));
+    pair<Graph, double> result =
+        RANDOM_TREE_MODEL == RandomTreeModel::GNP_SPANNING_TREE
+            ? generateRandomGraphWithProbability(total_nodes, generator, threads)
+            : pair<Graph, double>(RandomTrees::generateTreeGraph(RANDOM_TREE_MODEL, total_nodes, generator), 0);
+    logProgress("graph generation with " + std::to_string(total_nodes) + " is complete");
+    Graph MST = result.first;
+    double probability = result.second;
 
-    cout << "RUNNING for case " << caseid << " with " << total_nodes << " nodes"
-         << " and probability " << probability << endl;
+    logProgress("RUNNING for case " + std::to_string(caseid) + " with " + std::to_string(total_nodes) + " nodes" +
+                " and probability " + std::to_string(probability));
 
     int PACKING_COLORING_NODE_START =
         RootSelector::treeCenterRootSelectionScheme(MST);
 
-    std::cout << "Selected Root = " << PACKING_COLORING_NODE_START << endl;
+    logProgress("Selected Root = " + std::to_string(PACKING_COLORING_NODE_START));
 
     int MST_DIAMETER = GraphServices::computeDiamterOfArbitaryRootedTree(
                                     MST,
                                PACKING_COLORING_NODE_START);
 
+    MST.engine = PACKING_COLOR_ENGINE;
+    MST.coloringThreads = threads;
     auto procedure_start = std::chrono::high_resolution_clock::now();
     int uniquelyUsedColors =
         MST.approximatePackingColor(PACKING_COLORING_NODE_START);
     auto procedure_end = std::chrono::high_resolution_clock::now();
 
-    cout << "complete for" << caseid << " with " << total_nodes << " nodes"
-         << " and probability " << probability << endl;
+    logProgress("complete for" + std::to_string(caseid) + " with " + std::to_string(total_nodes) + " nodes" +
+                " and probability " + std::to_string(probability));
 
     std::chrono::duration<float> duration = procedure_end - procedure_start;
 
-    vector<Color> colors = MST.colors;
-
-    int maximumReusableColorID = -1;
-
-    map<int, int> colorCounter;
-
-    for (int i = 1; i < (int)colors.size(); i++) {
-        maximumReusableColorID =
-            std::max(colors[i].colorID, maximumReusableColorID);
-        colorCounter[colors[i].colorID]++;
-    }
+    int maximumReusableColorID = MST.colors.max();
+    vector<int> colorCounter = MST.colors.histogram(3);  // colors 1 and 2 are always reported
 
     int totalColorsUsed = maximumReusableColorID + uniquelyUsedColors;
 
@@ -300,30 +355,36 @@ void recordMultipleRandomGraphRuns(int caseid) {
      * - Total number of Color 1 used ✅
      * - Total number of Color 2 used ✅
      * - Fraction of Color 1 used w.r.t total nodes ✅
+     * - Nodes visited by the ball scans ✅
+     * - Distance oracle queries that replaced ball growth ✅
+     * - Base seed of the run ✅
+     * - Peak resident memory of the process so far ✅
      */
 
-    file << caseid << ","
-         << total_nodes << ","
-         << std::to_string(probability) << ","
-         << MST.edges.size() << ","
-         << PACKING_COLORING_NODE_START << ","
-         << duration.count() << " seconds,"
-         << maximumReusableColorID << ","
-         << totalColorsUsed << ","
-         << uniquelyUsedColors << ","
-         << "n/" << total_nodes / totalColorsUsed << ","
-         << colorCounter[1] << ","
-         << colorCounter[2] << ","
-         << ((double)colorCounter[1] / total_nodes) * 100 << "%,"
-         << MST_DIAMETER << ","
-         << "\n";
-
-    // Close the stats file at the end
-    file.close();
-
-    cout << "Case with nodes" << total_nodes << " complete"
-         << "\n"
-         << endl;
+    std::ostringstream row;
+    row << caseid << ","
+        << total_nodes << ","
+        << std::to_string(probability) << ","
+        << MST.edges.size() << ","
+        << PACKING_COLORING_NODE_START << ","
+        << duration.count() << " seconds,"
+        << maximumReusableColorID << ","
+        << totalColorsUsed << ","
+        << uniquelyUsedColors << ","
+        << "n/" << total_nodes / totalColorsUsed << ","
+        << colorCounter[1] << ","
+        << colorCounter[2] << ","
+        << ((double)colorCounter[1] / total_nodes) * 100 << "%,"
+        << MST_DIAMETER << ","
+        << MST.ballScanVisitedNodes << ","
+        << MST.distanceOracleQueries << ","
+        << seed << ","
+        << peakResidentSetMB() << ","
+        << "\n";
+
+    stats.submit(caseid, row.str());
+
+    logProgress("Case with nodes" + std::to_string(total_nodes) + " complete\n");
 }
 
 /**
@@ -333,6 +394,9 @@ void recordMultipleRandomGraphRuns(int caseid) {
  * components, reads the input from a file, and executes the required
  * operations.
  *
+ * Test cases run PARALLEL_TEST_CASES at a time, each on its own generator seeded with
+ * RANDOM_SEED and its case ID, and their rows reach stats.csv in case ID order.
+ *
  * @return int The exit status of the program.
  */
 int main() {
@@ -352,14 +416,33 @@ int main() {
     }
 
     file << MULTIPLE_RUN_CSV_HEADER << endl;
-    file.close();
 
     int testcases = 1;
     cin >> testcases;
-    int caseid = 1;
 
-    while (testcases--) {
-        std::cout << "recordMultipleRandomGraphRuns called with caseid " << caseid << endl;
-        recordMultipleRandomGraphRuns(caseid++);
-    }
+    vector<int> caseNodes(std::max(testcases, 0));
+    for (auto &total_nodes : caseNodes) cin >> total_nodes;
+
+    unsigned seed = RANDOM_SEED;
+    if (seed == 0)
+        seed = std::random_device()();
+    std::cout << "[Seed]: " << seed << endl;
+
+    // hardware_concurrency may be 0 when it is unknown
+    int caseThreads = std::max(1, std::min((int)PARALLEL_TEST_CASES, (int)caseNodes.size()));
+    int threadsPerCase = std::max(1, (int)COLORING_THREADS / caseThreads);
+
+    OrderedRowWriter writer(file);
+    std::atomic<int> nextCase(0);
+    ThreadTeam team(caseThreads);
+
+    team.run([&](int) {
+        for (int caseIndex; (caseIndex = nextCase++) < (int)caseNodes.size();) {
+            int caseid = caseIndex + 1;
+            logProgress("recordMultipleRandomGraphRuns called with caseid " + std::to_string(caseid));
+            recordMultipleRandomGraphRuns(caseid, caseNodes[caseIndex], seed, threadsPerCase, writer);
+        }
+    });
+
+    file.close();
 }
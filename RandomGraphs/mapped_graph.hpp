@@ -0,0 +1,206 @@
+#if !defined(MAPPED_GRAPH)
+#define MAPPED_GRAPH
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "graph.hpp"
+#include "root_selector.cpp"
+
+/**
+ * @namespace MappedGraph
+ * @brief Binary CSR graph files that are mapped into memory and used as a Graph's adjacency as is.
+ *
+ * A file is a Header followed by these sections of 4 byte integers in native byte order:
+ *   offsets       nodes + 2 entries, the CSRAdjacency offsets
+ *   neighbors     2 * edges entries, the CSRAdjacency neighbors
+ *   levelOffsets  levels + 1 entries, none when levels is 0
+ *   levelNodes    levelOffsets[levels] entries, the BFS levels from root
+ * Loading maps the file, checks every section in one read-only pass and points the adjacency
+ * at the first two sections, nothing is parsed and nothing proportional to the edges is copied.
+ * The level sections are copied into the graph's level order, so coloring from the stored root
+ * skips its BFS.
+ */
+namespace MappedGraph {
+constexpr char MAGIC[8] = {'P', 'C', 'C', 'S', 'R', 'G', 'R', 'F'};
+constexpr uint32_t VERSION = 1;
+
+struct Header {
+    char magic[8];
+    uint32_t version;
+    int32_t nodes;
+    int64_t edges;
+    int32_t root;   // 0 when no level order is stored
+    int32_t levels;
+};
+
+/**
+ * @brief Writes a graph and the BFS levels from root, compressing its adjacency first.
+ *
+ * @param root The node the levels are computed from, 0 stores no levels.
+ * @return False if the file could not be written.
+ */
+bool write(const std::string &path, Graph &graph, int root) {
+    graph.compressAdjacency();
+
+    Header header;
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.nodes = graph.maxNodes;
+    header.edges = graph.csr.neighbors.size() / 2;
+    header.root = root;
+    header.levels = 0;
+
+    if (root != 0) {
+        graph.calculateLevelOrderTraversal(root);
+        header.levels = graph.levelOrderTraversal.size();
+    }
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (not file.is_open())
+        return false;
+
+    auto writeSection = [&file](std::span<const int> section) {
+        file.write(reinterpret_cast<const char *>(section.data()), section.size_bytes());
+    };
+
+    file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    writeSection(graph.csr.offsets);
+    writeSection(graph.csr.neighbors);
+    if (header.levels > 0) {
+        writeSection(graph.levelOrderTraversal.offsets);
+        writeSection(graph.levelOrderTraversal.nodes);
+    }
+
+    return file.good();
+}
+
+/**
+ * True if a CSR offset section starts at 0, never decreases and ends at size.
+ */
+bool validOffsets(std::span<const int> offsets, size_t size) {
+    if (offsets.empty() or offsets.front() != 0 or (size_t)offsets.back() != size or offsets.back() < 0)
+        return false;
+
+    for (size_t i = 1; i < offsets.size(); i++) {
+        if (offsets[i] < offsets[i - 1])
+            return false;
+    }
+    return true;
+}
+
+/**
+ * True if every ID is a node of a graph on nodes nodes, 0 included.
+ */
+bool validNodeIDs(std::span<const int> ids, int nodes) {
+    for (int id : ids) {
+        if (id < 0 or id > nodes)
+            return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Maps a graph file and makes graph a graph over it.
+ *
+ * The adjacency stays mapped for as long as graph or a copy of it uses it. The edge list is
+ * not stored, graph.edges is left empty until expandAdjacency rebuilds it from the adjacency.
+ *
+ * @return False if the file could not be mapped, is not a graph file of this version or holds
+ * offsets or node IDs outside its sections, graph is then left untouched.
+ */
+bool load(const std::string &path, Graph &graph) {
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+        return false;
+
+    struct stat info;
+    void *mapped = MAP_FAILED;
+    if (fstat(fd, &info) == 0 and info.st_size >= (off_t)sizeof(Header))
+        mapped = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+
+    if (mapped == MAP_FAILED)
+        return false;
+
+    size_t length = info.st_size;
+    std::shared_ptr<const void> mapping(mapped, [length](const void *address) { munmap(const_cast<void *>(address), length); });
+
+    const Header &header = *static_cast<const Header *>(mapped);
+    if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 or header.version != VERSION or header.nodes < 0 or
+        header.edges < 0 or header.levels < 0)
+        return false;
+
+    // every section must lie inside the file before any of it is read
+    const int *sections = reinterpret_cast<const int *>(static_cast<const char *>(mapped) + sizeof(Header));
+    size_t available = (length - sizeof(Header)) / sizeof(int);
+    if ((uint64_t)header.edges > available / 2)
+        return false;
+
+    size_t adjacencyInts = (size_t)header.nodes + 2 + 2 * (size_t)header.edges;
+    size_t levelOffsetInts = header.levels > 0 ? (size_t)header.levels + 1 : 0;
+    if (adjacencyInts + levelOffsetInts > available)
+        return false;
+
+    std::span<const int> offsets(sections, header.nodes + 2);
+    std::span<const int> neighbors(sections + offsets.size(), 2 * header.edges);
+    std::span<const int> levelOffsets(neighbors.data() + neighbors.size(), levelOffsetInts);
+
+    // a negative last level offset would wrap the size sum, so it is rejected before the sum
+    size_t levelNodes = header.levels > 0 and levelOffsets.back() >= 0 ? (size_t)levelOffsets.back() : 0;
+    if (levelNodes > available - adjacencyInts - levelOffsetInts)
+        return false;
+
+    std::span<const int> levelNodeIDs(levelOffsets.data() + levelOffsets.size(), levelNodes);
+    if (not validOffsets(offsets, neighbors.size()) or not validNodeIDs(neighbors, header.nodes))
+        return false;
+    if (header.levels > 0 and (not validOffsets(levelOffsets, levelNodes) or not validNodeIDs(levelNodeIDs, header.nodes)))
+        return false;
+
+    graph = Graph(header.nodes, CSRAdjacency(offsets, neighbors, std::move(mapping)));
+
+    if (header.levels > 0) {
+        graph.levelOrderTraversal.offsets.assign(levelOffsets.begin(), levelOffsets.end());
+        graph.levelOrderTraversal.nodes.assign(levelNodeIDs.begin(), levelNodeIDs.end());
+    }
+
+    return true;
+}
+
+/**
+ * @brief Converts a text edge file of "u v" lines, as writeMSTEdgesToAFile writes them, to a graph file.
+ *
+ * @param root The node levels are stored from, 0 picks the tree center.
+ * @return False if either file could not be opened.
+ */
+bool convertEdgeFile(const std::string &textPath, const std::string &binaryPath, int root = 0) {
+    std::ifstream text(textPath);
+    if (not text.is_open())
+        return false;
+
+    std::vector<std::pair<int, int>> edges;
+    int maxNodeID = 0;
+    for (int from, to; text >> from >> to;) {
+        edges.push_back({from, to});
+        maxNodeID = std::max({maxNodeID, from, to});
+    }
+
+    Graph graph(maxNodeID, std::move(edges));
+    if (root == 0)
+        root = RootSelector::treeCenterRootSelectionScheme(graph);
+
+    return write(binaryPath, graph, root);
+}
+};  // namespace MappedGraph
+
+#endif  // MAPPED_GRAPH
@@ -0,0 +1,53 @@
+#if !defined(ORDERED_ROW_WRITER)
+#define ORDERED_ROW_WRITER
+
+#include <map>
+#include <mutex>
+#include <ostream>
+#include <string>
+
+/**
+ * @class OrderedRowWriter
+ * @brief Writes rows produced out of order by several threads, in ID order.
+ *
+ * Rows are numbered from `firstID`. A row that arrives early is held back until every
+ * row before it has been written, so the output is the same as a serial run's.
+ */
+class OrderedRowWriter {
+public:
+    /**
+     * @param stream The stream every row is written to, only touched under the writer's lock.
+     * @param firstID The ID of the first row.
+     */
+    OrderedRowWriter(std::ostream &stream, int firstID = 1) : out(stream), nextID(firstID) {}
+
+    /**
+     * @brief Hands over the row with the given ID, writing it and every held row that now follows.
+     */
+    void submit(int id, std::string row) {
+        std::lock_guard<std::mutex> lock(mutex);
+        heldRows[id] = std::move(row);
+
+        for (auto next = heldRows.begin(); next != heldRows.end() and next->first == nextID; next = heldRows.erase(next)) {
+            out << next->second;
+            nextID++;
+        }
+        out.flush();
+    }
+
+    /**
+     * @brief Rows still waiting for an earlier one.
+     */
+    int held() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return heldRows.size();
+    }
+
+private:
+    std::ostream &out;
+    int nextID;
+    std::map<int, std::string> heldRows;
+    std::mutex mutex;
+};
+
+#endif  // ORDERED_ROW_WRITER
@@ -0,0 +1,195 @@
+#if !defined(RANDOM_TREES)
+#define RANDOM_TREES
+
+#include <charconv>
+#include <fstream>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "graph.hpp"
+
+/**
+ * Where the spanning trees colored by the driver come from.
+ */
+enum class RandomTreeModel {
+    GNP_SPANNING_TREE,        // spanning tree of a G(n, p) graph, p in [log2(n) / n, 2 log2(n) / n)
+    PRUEFER,                  // uniform over all labeled trees, decoded from a random Pruefer sequence
+    RANDOM_RECURSIVE,         // node v hangs from a uniform node in 1 .. v - 1
+    UNIFORM_ATTACHMENT,       // same distribution as RANDOM_RECURSIVE
+    PREFERENTIAL_ATTACHMENT,  // node v hangs from a node in 1 .. v - 1 chosen with probability ~ its degree
+};
+
+/**
+ * Random trees generated edge by edge in O(n) time and memory, without a G(n, p) graph to span.
+ * Every generator hands its n - 1 edges to `emit(u, v)`, so they can be collected into a Graph
+ * or streamed to a file.
+ */
+namespace RandomTrees {
+/**
+ * @brief Decodes a Pruefer sequence into its labeled tree in linear time.
+ *
+ * The smallest leaf is tracked with a pointer that only moves forward: removing a leaf either
+ * makes its neighbor a leaf smaller than the pointer, which is then taken next, or the pointer
+ * moves on to the next leaf.
+ *
+ * @param n The number of nodes, labeled 1 .. n.
+ * @param sequence The Pruefer sequence, n - 2 labels in [1, n].
+ * @param emit Called with every edge (u, v) of the tree.
+ */
+template <typename EdgeSink>
+void decodePrueferSequence(int n, const std::vector<int> &sequence, EdgeSink &&emit) {
+    if (n < 2)
+        return;
+
+    std::vector<int> degree(n + 1, 1);
+    for (int label : sequence) degree[label]++;
+
+    int pointer = 1;
+    while (degree[pointer] != 1) pointer++;
+    int leaf = pointer;
+
+    for (int label : sequence) {
+        emit(leaf, label);
+
+        if (--degree[label] == 1 and label < pointer) {
+            leaf = label;
+        } else {
+            pointer++;
+            while (degree[pointer] != 1) pointer++;
+            leaf = pointer;
+        }
+    }
+
+    emit(leaf, n);
+}
+
+/**
+ * @brief A tree drawn uniformly from the n^(n - 2) labeled trees on n nodes.
+ */
+template <typename EdgeSink>
+void prueferTree(int n, std::mt19937 &generator, EdgeSink &&emit) {
+    std::uniform_int_distribution<int> label(1, std::max(n, 1));
+    std::vector<int> sequence(std::max(n - 2, 0));
+    for (auto &entry : sequence) entry = label(generator);
+
+    decodePrueferSequence(n, sequence, emit);
+}
+
+/**
+ * @brief A random recursive tree: node v is attached to a node of 1 .. v - 1 chosen uniformly.
+ */
+template <typename EdgeSink>
+void randomRecursiveTree(int n, std::mt19937 &generator, EdgeSink &&emit) {
+    for (int v = 2; v <= n; v++) {
+        std::uniform_int_distribution<int> parent(1, v - 1);
+        emit(parent(generator), v);
+    }
+}
+
+/**
+ * @brief Uniform attachment, which grows exactly the random recursive tree.
+ */
+template <typename EdgeSink>
+void uniformAttachmentTree(int n, std::mt19937 &generator, EdgeSink &&emit) {
+    randomRecursiveTree(n, generator, emit);
+}
+
+/**
+ * @brief Preferential attachment: node v is attached to a node of 1 .. v - 1 chosen with
+ * probability proportional to its degree (a Barabasi-Albert tree).
+ *
+ * Every edge endpoint is kept in one list, a node appears in it once per unit of degree,
+ * so a uniform entry of the list is a degree-weighted node.
+ */
+template <typename EdgeSink>
+void preferentialAttachmentTree(int n, std::mt19937 &generator, EdgeSink &&emit) {
+    if (n < 2)
+        return;
+
+    std::vector<int> endpoints;
+    endpoints.reserve(2 * (size_t)(n - 1));
+
+    emit(1, 2);
+    endpoints.push_back(1);
+    endpoints.push_back(2);
+
+    for (int v = 3; v <= n; v++) {
+        std::uniform_int_distribution<size_t> entry(0, endpoints.size() - 1);
+        int parent = endpoints[entry(generator)];
+
+        emit(parent, v);
+        endpoints.push_back(parent);
+        endpoints.push_back(v);
+    }
+}
+
+/**
+ * @brief Runs the generator of a model, GNP_SPANNING_TREE is not generated here.
+ */
+template <typename EdgeSink>
+void generateTree(RandomTreeModel model, int n, std::mt19937 &generator, EdgeSink &&emit) {
+    switch (model) {
+        case RandomTreeModel::PRUEFER:
+            prueferTree(n, generator, emit);
+            break;
+        case RandomTreeModel::RANDOM_RECURSIVE:
+            randomRecursiveTree(n, generator, emit);
+            break;
+        case RandomTreeModel::UNIFORM_ATTACHMENT:
+            uniformAttachmentTree(n, generator, emit);
+            break;
+        case RandomTreeModel::PREFERENTIAL_ATTACHMENT:
+            preferentialAttachmentTree(n, generator, emit);
+            break;
+        case RandomTreeModel::GNP_SPANNING_TREE:
+            break;
+    }
+}
+
+/**
+ * @brief Generates a random tree straight into a Graph in CSR form.
+ */
+Graph generateTreeGraph(RandomTreeModel model, int n, std::mt19937 &generator) {
+    std::vector<std::pair<int, int>> edges;
+    edges.reserve(n > 0 ? n - 1 : 0);
+
+    generateTree(model, n, generator, [&edges](int u, int v) { edges.push_back({u, v}); });
+
+    return Graph(n, std::move(edges));
+}
+
+/**
+ * @brief Streams a random tree to a file, one "u v" line per edge like the generated MST files,
+ * without keeping its edges in memory.
+ *
+ * @return False if the file could not be written.
+ */
+bool writeTreeToFile(const std::string &path, RandomTreeModel model, int n, std::mt19937 &generator) {
+    std::ofstream file(path, std::ios::trunc | std::ios::binary);
+    if (not file.is_open())
+        return false;
+
+    std::vector<char> buffer(1 << 16);
+    size_t used = 0;
+
+    generateTree(model, n, generator, [&](int u, int v) {
+        if (used + 32 > buffer.size()) {
+            file.write(buffer.data(), used);
+            used = 0;
+        }
+
+        char *end = std::to_chars(buffer.data() + used, buffer.data() + buffer.size(), u).ptr;
+        *end++ = ' ';
+        end = std::to_chars(end, buffer.data() + buffer.size(), v).ptr;
+        *end++ = '\n';
+        used = end - buffer.data();
+    });
+
+    file.write(buffer.data(), used);
+    return (bool)file;
+}
+};  // namespace RandomTrees
+
+#endif  // RANDOM_TREES
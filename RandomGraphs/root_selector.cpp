@@ -18,9 +18,8 @@ namespace RootSelector {
 int treeCenterRootSelectionScheme(Graph &g) {
     std::vector<int> degree(g.maxNodes + 1, 0);
 
-    for (auto edge : g.edges) {
-        degree[edge.first]++; degree[edge.second]++;
-    }
+    // read from the adjacency, a graph loaded from a mapped file has no edge list
+    for (int i = 0; i <= g.maxNodes; ++i) degree[i] = g.neighbors(i).size();
 
     // where degree[i] is 1, we identify them as leaf nodes
     // we will remove these leaf nodes and their edges from the graph
@@ -39,7 +38,7 @@ int treeCenterRootSelectionScheme(Graph &g) {
         q.pop();
         --degree[front];
 
-        for (auto nbr : g.adj_list[front]) {
+        for (auto nbr : g.neighbors(front)) {
             --degree[nbr];
             if (degree[nbr] == 1 or degree[nbr] == 0) {
                 q.push(nbr);
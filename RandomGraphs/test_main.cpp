@@ -1,6 +1,22 @@
+#include "./tests/test_graph.h"
 #include "./tests/test_tree.h"
 
 int main() {
     test_buildLevelOrderTraversalStructureWithTreeReference();
+    test_ballScanForColor();
+    test_colorPresenceBitmap();
+    test_colorArray();
+    test_csrAdjacency();
+    test_levelOrder();
+    test_lcaDistanceOracle();
+    test_centroidColorIndex();
+    test_parallelColoring();
+    test_concurrentTestCases();
+    test_geometricSkipGnP();
+    test_randomTrees();
+    test_fusedSpanningTree();
+    test_disjointSets();
+    test_mappedGraph();
+    test_edgeArchive();
     return 0;
-}
\ No newline at end of file
+}
@@ -0,0 +1,649 @@
+#if !defined(GRAPH_TESTS)
+#define GRAPH_TESTS
+
+#include <cassert>
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <sstream>
+
+#include "../edge_archive.hpp"
+#include "../graph.hpp"
+#include "../mapped_graph.hpp"
+#include "../ordered_row_writer.hpp"
+#include "../random_trees.hpp"
+#include "test_utils.h"
+
+/**
+ * Builds a random tree on n nodes where node v hangs from one of the
+ * previous `window` nodes, and colors every third node with a small color.
+ */
+Graph buildPartiallyColoredRandomTree(int n, int window, unsigned seed) {
+    std::mt19937 generator(seed);
+    Graph g(n);
+
+    for (int v = 2; v <= n; v++) {
+        std::uniform_int_distribution<int> parent(std::max(1, v - window), v - 1);
+        g.add_edge(parent(generator), v);
+    }
+
+    std::uniform_int_distribution<int> smallColor(1, 6);
+    for (int v = 1; v <= n; v += 3) g.colors.set(v, smallColor(generator));
+
+    return g;
+}
+
+/**
+ * Smallest color c such that travelForColor(c) does not see c, this is
+ * how approximatePackingColor used to pick the color of a candidate.
+ */
+int smallestPackableColorByTravelling(Graph &g, int candidate) {
+    for (int color = 1; color < g.maxNodes; color++) {
+        if (not g.travelForColor(Color(color), candidate).test(color))
+            return color;
+    }
+    return 0;
+}
+
+void test_ballScanForColor() {
+    std::string fn_name = "Ball Scan For Color";
+    TestAssertService::setUp(fn_name);
+
+    bool pathMatches = true, bushyMatches = true;
+
+    Graph path = buildPartiallyColoredRandomTree(300, 1, 7);
+    for (int v = 1; v <= path.maxNodes; v++) {
+        if (path.colors[v] != 0) continue;
+        pathMatches &= path.ballScanForColor(v, path.maxNodes - 1) == smallestPackableColorByTravelling(path, v);
+    }
+
+    Graph bushy = buildPartiallyColoredRandomTree(300, 300, 11);
+    for (int v = 1; v <= bushy.maxNodes; v++) {
+        if (bushy.colors[v] != 0) continue;
+        bushyMatches &= bushy.ballScanForColor(v, bushy.maxNodes - 1) == smallestPackableColorByTravelling(bushy, v);
+    }
+
+    TestAssertService::assertTrue(pathMatches, "matches travel on path");
+    TestAssertService::assertTrue(bushyMatches, "matches travel on bushy");
+
+    Graph single(1);
+    TestAssertService::assertEqual(single.ballScanForColor(1, 0), 0, "no color to explore");
+
+    TestAssertService::cleanUp(fn_name);
+}
+
+void test_colorPresenceBitmap() {
+    std::string fn_name = "Color Presence Bitmap";
+    TestAssertService::setUp(fn_name);
+
+    ColorPresenceBitmap bitmap(200);
+    for (int color = 1; color <= 130; color++) bitmap.insert(color);
+    bitmap.insert(0);
+    bitmap.insert(500);  // above capacity, ignored
+
+    TestAssertService::assertEqual(bitmap.test(64), true, "present across words");
+    TestAssertService::assertEqual(bitmap.test(131), false, "absent color");
+    TestAssertService::assertEqual(bitmap.firstAbsentFrom(1), 131, "first absent color");
+    TestAssertService::assertEqual(bitmap.firstAbsentFrom(140), 140, "absent start color");
+    TestAssertService::assertEqual(bitmap.count(), 131, "present colors");
+
+    for (int color = 131; color <= 200; color++) bitmap.insert(color);
+    TestAssertService::assertEqual(bitmap.firstAbsentFrom(1), 201, "full bitmap");
+
+    bitmap.clear();
+    TestAssertService::assertEqual(bitmap.count(), 0, "cleared bitmap");
+    TestAssertService::assertEqual(bitmap.firstAbsentFrom(0), 0, "cleared first absent");
+
+    TestAssertService::cleanUp(fn_name);
+}
+
+void test_colorArray() {
+    std::string fn_name = "Color Array";
+    TestAssertService::setUp(fn_name);
+
+    ColorArray colors(11);
+    TestAssertService::assertEqual(colors.bytesPerColor(), 1, "starts narrow");
+
+    std::vector<int> level = {2, 4, 6};
+    colors.fill(level, 1);
+    colors.set(3, 255);
+    TestAssertService::assertEqual(colors.bytesPerColor(), 1, "255 fits a byte");
+
+    colors.set(5, 256);
+    TestAssertService::assertEqual(colors.bytesPerColor(), 2, "promoted to 16 bits");
+    colors.set(7, 70000);
+    TestAssertService::assertEqual(colors.bytesPerColor(), 4, "promoted to 32 bits");
+
+    bool kept = colors[2] == 1 and colors[4] == 1 and colors[6] == 1 and colors[3] == 255 and colors[5] == 256;
+    TestAssertService::assertTrue(kept, "promotion keeps colors");
+    TestAssertService::assertEqual(colors[7], 70000, "wide color");
+    TestAssertService::assertEqual(colors.max(), 70000, "max color");
+
+    std::vector<int> counts = colors.histogram();
+    TestAssertService::assertEqual((int)counts.size(), 70001, "histogram up to max");
+    bool counted = counts[0] == 4 and counts[1] == 3 and counts[255] == 1 and counts[256] == 1 and counts[70000] == 1;
+    TestAssertService::assertTrue(counted, "histogram skips node 0");
+
+    colors.assign(5, 0);
+    TestAssertService::assertEqual(colors.bytesPerColor(), 1, "reassigned narrow");
+    TestAssertService::assertEqual((int)colors.histogram(3).size(), 3, "histogram min colors");
+
+    TestAssertService::cleanUp(fn_name);
+}
+
+void test_csrAdjacency() {
+    std::string fn_name = "CSR Adjacency";
+    TestAssertService::setUp(fn_name);
+
+    Graph lists = buildPartiallyColoredRandomTree(500, 20, 3);
+    Graph compressed(lists.maxNodes, lists.edges);
+    compressed.colors = lists.colors;
+
+    bool sameNeighbors = true;
+    for (int v = 0; v <= lists.maxNodes; v++) {
+        auto expected = lists.adj_list[v];
+        auto actual = compressed.neighbors(v);
+        sameNeighbors &= std::equal(expected.begin(), expected.end(), actual.begin(), actual.end());
+    }
+    TestAssertService::assertTrue(sameNeighbors, "same neighbor order");
+    TestAssertService::assertEqual((int)compressed.adj_list.size(), 0, "no adjacency lists");
+
+    Graph uncolored = buildPartiallyColoredRandomTree(500, 20, 3);
+    Graph uncoloredCompressed(uncolored.maxNodes, uncolored.edges);
+    uncolored.colors.assign(uncolored.maxNodes + 1, 0);
+    uncolored.approximatePackingColor(1);
+    uncoloredCompressed.approximatePackingColor(1);
+
+    bool sameColors = true;
+    for (int v = 1; v <= uncolored.maxNodes; v++) sameColors &= uncolored.colors[v] == uncoloredCompressed.colors[v];
+    TestAssertService::assertTrue(sameColors, "same coloring");
+
+    compressed.add_edge(1, 500);
+    TestAssertService::assertTrue(compressed.csr.empty(), "add_edge expands");
+    TestAssertService::assertEqual((int)compressed.neighbors(1).size(), (int)lists.adj_list[1].size() + 1, "edge added");
+
+    TestAssertService::cleanUp(fn_name);
+}
+
+void test_levelOrder() {
+    std::string fn_name = "Level Order";
+    TestAssertService::setUp(fn_name);
+
+    Graph g = buildPartiallyColoredRandomTree(600, 8, 13);
+    g.add_edge(600, 1);  // a cycle does not change depths
+
+    // the levels of a plain BFS with a queue of (node, depth), as the traversal used to be built
+    vector<vector<int>> expected;
+    vector<bool> visited(g.maxNodes + 1, false);
+    queue<pair<int, int>> q;
+    q.push({40, 0});
+    visited[40] = true;
+    while (not q.empty()) {
+        auto [node, depth] = q.front();
+        q.pop();
+        if (depth == (int)expected.size())
+            expected.push_back({});
+        expected[depth].push_back(node);
+        for (int nbr : g.neighbors(node)) {
+            if (not visited[nbr]) {
+                visited[nbr] = true;
+                q.push({nbr, depth + 1});
+            }
+        }
+    }
+
+    // computed twice, the second call replaces the levels of the first
+    g.calculateLevelOrderTraversal(7);
+    g.calculateLevelOrderTraversal(40);
+
+    bool sameLevels = g.levelOrderTraversal.size() == (int)expected.size();
+    for (int level = 0; sameLevels and level < g.levelOrderTraversal.size(); level++) {
+        auto actual = g.levelOrderTraversal[level];
+        sameLevels &= std::equal(expected[level].begin(), expected[level].end(), actual.begin(), actual.end());
+    }
+    TestAssertService::assertTrue(sameLevels, "same levels as BFS");
+    TestAssertService::assertEqual((int)g.levelOrderTraversal.nodes.size(), g.maxNodes, "every node once");
+
+    Graph single(1);
+    single.calculateLevelOrderTraversal(1);
+    TestAssertService::assertEqual(single.levelOrderTraversal.size(), 1, "single level");
+
+    TestAssertService::cleanUp(fn_name);
+}
+
+void test_lcaDistanceOracle() {
+    std::string fn_name = "LCA Distance Oracle";
+    TestAssertService::setUp(fn_name);
+
+    Graph g = buildPartiallyColoredRandomTree(400, 30, 5);
+    LCADistanceOracle oracle;
+    bool built = oracle.build(g.maxNodes, 17, [&g](int node) { return g.neighbors(node); });
+    TestAssertService::assertTrue(built, "tree is indexed");
+
+    // distances from a few sources against a plain BFS
+    bool sameDistances = true;
+    for (int source : {1, 17, 250, 400}) {
+        vector<int> bfsDistance(g.maxNodes + 1, -1);
+        queue<int> q;
+        q.push(source);
+        bfsDistance[source] = 0;
+
+        while (not q.empty()) {
+            int node = q.front();
+            q.pop();
+            for (int nbr : g.neighbors(node)) {
+                if (bfsDistance[nbr] == -1) {
+                    bfsDistance[nbr] = bfsDistance[node] + 1;
+                    q.push(nbr);
+                }
+            }
+        }
+
+        for (int v = 1; v <= g.maxNodes; v++) sameDistances &= oracle.distance(source, v) == bfsDistance[v];
+    }
+    TestAssertService::assertTrue(sameDistances, "distances match BFS");
+
+    g.add_edge(1, 2);  // closes a cycle
+    TestAssertService::assertFalse(oracle.build(g.maxNodes, 1, [&g](int node) { return g.neighbors(node); }), "cycle is rejected");
+
+    // the oracle only changes how colors are checked, never the coloring
+    Graph withOracle = buildPartiallyColoredRandomTree(2000, 2000, 9);
+    Graph withoutOracle = withOracle;
+    withOracle.colors.assign(withOracle.maxNodes + 1, 0);
+    withoutOracle.colors.assign(withoutOracle.maxNodes + 1, 0);
+    withoutOracle.distanceOracleHolderLimit = 0;
+
+    withOracle.approximatePackingColor(1);
+    withoutOracle.approximatePackingColor(1);
+
+    bool sameColors = true;
+    for (int v = 1; v <= withOracle.maxNodes; v++) sameColors &= withOracle.colors[v] == withoutOracle.colors[v];
+    TestAssertService::assertTrue(sameColors, "same coloring");
+    TestAssertService::assertLessThan(withOracle.ballScanVisitedNodes, withoutOracle.ballScanVisitedNodes, "fewer BFS visits");
+
+    TestAssertService::cleanUp(fn_name);
+}
+
+void test_centroidColorIndex() {
+    std::string fn_name = "Centroid Color Index";
+    TestAssertService::setUp(fn_name);
+
+    Graph g = buildPartiallyColoredRandomTree(300, 12, 21);
+    CentroidColorIndex index;
+    bool built = index.build(g.maxNodes, 1, [&g](int node) { return g.neighbors(node); });
+    TestAssertService::assertTrue(built, "tree is decomposed");
+
+    LCADistanceOracle oracle;
+    oracle.build(g.maxNodes, 1, [&g](int node) { return g.neighbors(node); });
+
+    for (int v = 1; v <= g.maxNodes; v++) {
+        if (g.colors[v] != 0) index.mark(v, g.colors[v]);
+    }
+    index.mark(42, 1000);  // a rare color goes through the hash table
+
+    // nearest holders against a brute force over all holders
+    bool sameNearest = true;
+    for (int u = 1; u <= g.maxNodes; u++) {
+        for (int color : {1, 2, 5, 6, 7, 1000}) {
+            int closest = INT_MAX;
+            for (int v = 1; v <= g.maxNodes; v++) {
+                int held = v == 42 ? 1000 : g.colors[v];
+                if (held == color) closest = std::min(closest, oracle.distance(u, v));
+            }
+            sameNearest &= index.nearest(u, color) == closest;
+        }
+    }
+    TestAssertService::assertTrue(sameNearest, "nearest matches brute force");
+
+    // both engines color the same tree the same way
+    bool sameColors = true;
+    for (unsigned seed : {1u, 2u, 3u}) {
+        Graph ballScan = buildPartiallyColoredRandomTree(1500, seed == 2 ? 1500 : 25, seed);
+        ballScan.colors.assign(ballScan.maxNodes + 1, 0);
+        Graph centroid = ballScan;
+        centroid.engine = PackingColorEngine::CENTROID_INDEX;
+
+        int uniquelyUsedByBallScan = ballScan.approximatePackingColor(1);
+        int uniquelyUsedByCentroid = centroid.approximatePackingColor(1);
+
+        sameColors &= uniquelyUsedByBallScan == uniquelyUsedByCentroid;
+        for (int v = 1; v <= ballScan.maxNodes; v++) sameColors &= ballScan.colors[v] == centroid.colors[v];
+        sameColors &= centroid.ballScanVisitedNodes == 0;
+    }
+    TestAssertService::assertTrue(sameColors, "engines agree");
+
+    TestAssertService::cleanUp(fn_name);
+}
+
+void test_parallelColoring() {
+    std::string fn_name = "Parallel Coloring";
+    TestAssertService::setUp(fn_name);
+
+    // bushy trees have wide levels with many conflicts, deep ones many narrow levels
+    bool sameColors = true;
+    for (unsigned seed : {4u, 5u, 6u}) {
+        Graph sequential = buildPartiallyColoredRandomTree(20000, seed == 5 ? 20000 : 30, seed);
+        sequential.colors.assign(sequential.maxNodes + 1, 0);
+
+        for (auto engine : {PackingColorEngine::BALL_SCAN, PackingColorEngine::CENTROID_INDEX}) {
+            Graph parallel = sequential;
+            parallel.engine = engine;
+            parallel.coloringThreads = 4;
+
+            Graph reference = sequential;
+            int uniquelyUsedSequentially = reference.approximatePackingColor(1);
+            int uniquelyUsedInParallel = parallel.approximatePackingColor(1);
+
+            sameColors &= uniquelyUsedSequentially == uniquelyUsedInParallel;
+            for (int v = 1; v <= reference.maxNodes; v++) sameColors &= reference.colors[v] == parallel.colors[v];
+        }
+    }
+    TestAssertService::assertTrue(sameColors, "threads match sequential");
+
+    TestAssertService::cleanUp(fn_name);
+}
+
+void test_concurrentTestCases() {
+    std::string fn_name = "Concurrent Test Cases";
+    TestAssertService::setUp(fn_name);
+
+    // a case only depends on its generator
+    std::mt19937 first(99), second(99);
+    auto a = GraphServices::generateGnP(200, 0.05, first);
+    auto b = GraphServices::generateGnP(200, 0.05, second);
+    TestAssertService::assertTrue(a.first.edges == b.first.edges, "same seed same graph");
+
+    // rows submitted from several threads come out in ID order
+    std::ostringstream csv;
+    OrderedRowWriter writer(csv);
+    ThreadTeam team(4);
+    team.run([&](int id) {
+        for (int row = 4 - id; row <= 40; row += 4) writer.submit(row, std::to_string(row) + "\n");
+    });
+
+    std::string expected;
+    for (int row = 1; row <= 40; row++) expected += std::to_string(row) + "\n";
+    TestAssertService::assertTrue(csv.str() == expected, "rows in ID order");
+    TestAssertService::assertEqual(writer.held(), 0, "nothing held back");
+
+    TestAssertService::cleanUp(fn_name);
+}
+
+void test_geometricSkipGnP() {
+    std::string fn_name = "Geometric Skip G(n,p)";
+    TestAssertService::setUp(fn_name);
+
+    // the seed alone decides the graph, not the thread count
+    std::mt19937 single(5), several(5);
+    auto sequential = GraphServices::generateGnP(3000, 0.01, single, 1);
+    auto parallel = GraphServices::generateGnP(3000, 0.01, several, 4);
+    TestAssertService::assertTrue(sequential.first.edges == parallel.first.edges, "same graph on any threads");
+
+    // pairs come out once each, i < j, in the order of the nested loop
+    auto &edges = sequential.first.edges;
+    bool ordered = true;
+    for (size_t e = 0; e < edges.size(); e++) {
+        ordered &= 1 <= edges[e].first and edges[e].first < edges[e].second and edges[e].second <= 3000;
+        if (e > 0)
+            ordered &= edges[e - 1] < edges[e];
+    }
+    TestAssertService::assertTrue(ordered, "pairs in loop order");
+
+    // m ~ Binomial(4498500, 0.01): mean 44985, standard deviation 211
+    TestAssertService::assertTrue(std::abs((long long)edges.size() - 44985) < 6 * 211, "edge count near mean");
+
+    std::mt19937 complete(1);
+    TestAssertService::assertEqual((int)GraphServices::generateGnP(40, 1, complete).first.edges.size(), 40 * 39 / 2, "p = 1 is complete");
+
+    // the first and the last pair are reachable
+    bool firstPair = false, lastPair = false;
+    for (unsigned seed = 0; seed < 200 and not (firstPair and lastPair); seed++) {
+        std::mt19937 generator(seed);
+        auto small = GraphServices::generateGnP(4, 0.5, generator);
+        for (auto edge : small.first.edges) {
+            firstPair |= edge == std::make_pair(1, 2);
+            lastPair |= edge == std::make_pair(3, 4);
+        }
+    }
+    TestAssertService::assertTrue(firstPair and lastPair, "first and last pair sampled");
+
+    TestAssertService::cleanUp(fn_name);
+}
+
+void test_randomTrees() {
+    std::string fn_name = "Random Trees";
+    TestAssertService::setUp(fn_name);
+
+    // the classic example: 4 4 4 5 decodes to a star around 4 with 4 - 5 - 6
+    vector<pair<int, int>> decoded;
+    RandomTrees::decodePrueferSequence(6, {4, 4, 4, 5}, [&](int u, int v) { decoded.push_back({u, v}); });
+    vector<pair<int, int>> expected = {{1, 4}, {2, 4}, {3, 4}, {4, 5}, {5, 6}};
+    TestAssertService::assertTrue(decoded == expected, "decodes known sequence");
+
+    // every model spans 1 .. n with n - 1 edges
+    bool spanning = true;
+    for (auto model : {RandomTreeModel::PRUEFER, RandomTreeModel::RANDOM_RECURSIVE,
+                       RandomTreeModel::UNIFORM_ATTACHMENT, RandomTreeModel::PREFERENTIAL_ATTACHMENT}) {
+        for (int n : {1, 2, 3, 1000}) {
+            std::mt19937 generator(n);
+            Graph tree = RandomTrees::generateTreeGraph(model, n, generator);
+
+            DisjointSet ds(n);
+            int merged = 0;
+            for (auto edge : tree.edges) {
+                spanning &= 1 <= edge.first and edge.first <= n and 1 <= edge.second and edge.second <= n;
+                merged += spanning and ds.Union(edge.first, edge.second);
+            }
+            spanning &= (int)tree.edges.size() == n - 1 and merged == n - 1;
+        }
+    }
+    TestAssertService::assertTrue(spanning, "models span the nodes");
+
+    // Pruefer trees are uniform: all 4^2 = 16 labeled trees on 4 nodes show up evenly
+    std::map<vector<pair<int, int>>, int> seen;
+    std::mt19937 generator(3);
+    for (int sample = 0; sample < 16000; sample++) {
+        vector<pair<int, int>> edges;
+        RandomTrees::prueferTree(4, generator, [&](int u, int v) { edges.push_back(std::minmax(u, v)); });
+        std::sort(edges.begin(), edges.end());
+        seen[edges]++;
+    }
+    bool even = seen.size() == 16;
+    for (auto &tree : seen) even &= std::abs(tree.second - 1000) < 150;
+    TestAssertService::assertTrue(even, "uniform labeled trees");
+
+    TestAssertService::cleanUp(fn_name);
+}
+
+void test_fusedSpanningTree() {
+    std::string fn_name = "Fused Spanning Tree";
+    TestAssertService::setUp(fn_name);
+
+    // the fused stage keeps exactly the tree generateMST picks from the stored graph
+    bool sameTree = true;
+    for (double p : {0.0, 0.002, 0.3, 1.0}) {
+        std::mt19937 stored(17), fused(17);
+        auto graph = GraphServices::generateGnP(2000, p, stored);
+        Graph expected = GraphServices::generateMST(graph.first);
+        auto tree = GraphServices::generateGnPSpanningTree(2000, p, fused);
+
+        sameTree &= tree.second == graph.second and tree.first.edges == expected.edges;
+    }
+    TestAssertService::assertTrue(sameTree, "same tree as generateMST");
+
+    TestAssertService::cleanUp(fn_name);
+}
+
+void test_disjointSets() {
+    std::string fn_name = "Disjoint Sets";
+    TestAssertService::setUp(fn_name);
+
+    // a chain far deeper than the call stack allows recursing into
+    int chain = 3000000;
+    DisjointSet deep(chain);
+    for (int v = 2; v <= chain; v++) deep.parent[v] = v - 1;
+    TestAssertService::assertEqual(deep.Find(chain), 1, "deep chain root");
+    int depth = 0;
+    for (uint32_t v = chain; deep.parent[v] != v; v = deep.parent[v]) depth++;
+    TestAssertService::assertTrue(depth <= chain / 2, "path is halved");
+
+    // slices filtered on several threads keep exactly the edges sequential Kruskal keeps
+    std::mt19937 generator(8);
+    auto gnp = GraphServices::generateGnP(20000, 0.0002, generator);
+    Graph sequential = GraphServices::generateMST(gnp.first);
+
+    bool sameTree = true;
+    for (int threads : {2, 4, 7}) {
+        Graph parallel = GraphServices::generateMST(gnp.first, threads);
+        sameTree &= parallel.edges == sequential.edges;
+    }
+    TestAssertService::assertTrue(sameTree, "parallel MST is the sequential one");
+
+    TestAssertService::cleanUp(fn_name);
+}
+
+void test_mappedGraph() {
+    std::string fn_name = "Mapped Graph Files";
+    TestAssertService::setUp(fn_name);
+
+    std::string path = (std::filesystem::temp_directory_path() / "packing_coloring_test_graph.csr").string();
+
+    Graph original = buildPartiallyColoredRandomTree(3000, 40, 21);
+    original.colors.assign(original.maxNodes + 1, 0);
+    int root = RootSelector::treeCenterRootSelectionScheme(original);
+    TestAssertService::assertTrue(MappedGraph::write(path, original, root), "written");
+
+    Graph loaded(0);
+    TestAssertService::assertTrue(MappedGraph::load(path, loaded), "loaded");
+    TestAssertService::assertEqual(loaded.maxNodes, original.maxNodes, "node count");
+
+    bool sameNeighbors = true;
+    for (int v = 0; v <= original.maxNodes; v++) {
+        auto expected = original.neighbors(v);
+        auto actual = loaded.neighbors(v);
+        sameNeighbors &= std::equal(expected.begin(), expected.end(), actual.begin(), actual.end());
+    }
+    TestAssertService::assertTrue(sameNeighbors, "same neighbor order");
+    TestAssertService::assertTrue(loaded.levelOrderTraversal.nodes == original.levelOrderTraversal.nodes and
+                                      loaded.levelOrderTraversal.offsets == original.levelOrderTraversal.offsets,
+                                  "stored levels");
+
+    // copies share the mapping, which outlives the graph it was loaded into
+    Graph copy = loaded;
+    loaded = Graph(0);
+    int uniqueOriginal = original.approximatePackingColor(root);
+    int uniqueCopy = copy.approximatePackingColor(root);
+
+    bool sameColors = uniqueOriginal == uniqueCopy;
+    for (int v = 1; v <= original.maxNodes; v++) sameColors &= original.colors[v] == copy.colors[v];
+    TestAssertService::assertTrue(sameColors, "same coloring");
+
+    copy.expandAdjacency();
+    TestAssertService::assertEqual((int)copy.edges.size(), original.maxNodes - 1, "edges rebuilt");
+
+    // a file cut short is rejected before any section is read
+    std::filesystem::resize_file(path, std::filesystem::file_size(path) - sizeof(int));
+    Graph truncated(0);
+    TestAssertService::assertTrue(not MappedGraph::load(path, truncated), "truncated file rejected");
+
+    // sections of the right size whose contents point outside the graph are rejected as well
+    auto rejectedWith = [&](size_t index, int value) {
+        MappedGraph::write(path, original, root);
+        std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+        file.seekp(sizeof(MappedGraph::Header) + index * sizeof(int));
+        file.write(reinterpret_cast<const char *>(&value), sizeof(value));
+        file.close();
+
+        Graph corrupted(0);
+        return not MappedGraph::load(path, corrupted);
+    };
+
+    size_t neighborsStart = original.maxNodes + 2;
+    size_t levelOffsetsStart = neighborsStart + original.csr.neighbors.size();
+    size_t lastLevelOffset = levelOffsetsStart + original.levelOrderTraversal.offsets.size() - 1;
+    TestAssertService::assertTrue(not rejectedWith(0, 0), "rewritten file loads");
+    TestAssertService::assertTrue(rejectedWith(1, (int)original.csr.neighbors.size() + 1), "offset past neighbors");
+    TestAssertService::assertTrue(rejectedWith(neighborsStart + 5, original.maxNodes + 1), "neighbor out of range");
+    TestAssertService::assertTrue(rejectedWith(neighborsStart, -1), "negative neighbor");
+    TestAssertService::assertTrue(rejectedWith(levelOffsetsStart + 1, -3), "decreasing level offsets");
+    TestAssertService::assertTrue(rejectedWith(lastLevelOffset, -1), "negative level size");
+    TestAssertService::assertTrue(rejectedWith(lastLevelOffset + 2, original.maxNodes + 7), "level node out of range");
+    std::filesystem::remove(path);
+
+    TestAssertService::cleanUp(fn_name);
+}
+
+void test_edgeArchive() {
+    std::string fn_name = "Edge Archive";
+    TestAssertService::setUp(fn_name);
+
+    std::string path = (std::filesystem::temp_directory_path() / "packing_coloring_test_edges.pea").string();
+
+    std::mt19937 generator(17);
+    Graph original = RandomTrees::generateTreeGraph(RandomTreeModel::PREFERENTIAL_ATTACHMENT, 5000, generator);
+    TestAssertService::assertTrue(EdgeArchive::write(path, original.maxNodes, original.edges, 300), "written");
+
+    // the archive holds the edges smaller ID first, sorted
+    vector<pair<int, int>> sorted = original.edges;
+    for (auto &edge : sorted) edge = {std::min(edge.first, edge.second), std::max(edge.first, edge.second)};
+    std::sort(sorted.begin(), sorted.end());
+
+    EdgeArchive::Reader reader(path);
+    TestAssertService::assertTrue((bool)reader, "index read");
+    TestAssertService::assertEqual((int)reader.blocks.size(), (4999 + 299) / 300, "block count");
+
+    vector<pair<int, int>> decoded;
+    reader.forEachEdge([&decoded](int u, int v) { decoded.push_back({u, v}); });
+    TestAssertService::assertTrue(decoded == sorted, "round trip");
+
+    vector<pair<int, int>> block;
+    reader.forEachEdgeIn(7, [&block](int u, int v) { block.push_back({u, v}); });
+    TestAssertService::assertTrue(std::equal(block.begin(), block.end(), sorted.begin() + 7 * 300), "block decodes alone");
+
+    Graph loaded(0);
+    TestAssertService::assertTrue(EdgeArchive::load(path, loaded), "loaded");
+    Graph expected(original.maxNodes, sorted);
+
+    bool sameNeighbors = true;
+    for (int v = 0; v <= original.maxNodes; v++) {
+        auto want = expected.neighbors(v);
+        auto got = loaded.neighbors(v);
+        sameNeighbors &= std::equal(want.begin(), want.end(), got.begin(), got.end());
+    }
+    TestAssertService::assertTrue(sameNeighbors, "streamed into CSR");
+    TestAssertService::assertTrue(loaded.edges.empty(), "no edge list held");
+
+    // a file cut short fails to load instead of building a partial graph
+    std::filesystem::resize_file(path, std::filesystem::file_size(path) - 1);
+    Graph truncated(0);
+    TestAssertService::assertTrue(not EdgeArchive::load(path, truncated), "truncated file rejected");
+
+    // counts in the header and index are checked against the file size before anything is sized from them
+    auto rejectedWith = [&](size_t at, uint32_t value) {
+        EdgeArchive::write(path, original.maxNodes, original.edges, 300);
+        std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+        file.seekp(at);
+        file.write(reinterpret_cast<const char *>(&value), sizeof(value));
+        file.close();
+
+        return not EdgeArchive::Reader(path);
+    };
+
+    size_t firstBlock = sizeof(EdgeArchive::Header);
+    TestAssertService::assertTrue(not rejectedWith(offsetof(EdgeArchive::Header, blockCount), reader.header.blockCount),
+                                  "rewritten archive reads");
+    TestAssertService::assertTrue(rejectedWith(offsetof(EdgeArchive::Header, blockCount), 0xfffffff0u), "huge block count");
+    TestAssertService::assertTrue(rejectedWith(firstBlock + offsetof(EdgeArchive::BlockEntry, bytes), 0xfffffff0u),
+                                  "block past the payload");
+    TestAssertService::assertTrue(rejectedWith(firstBlock + offsetof(EdgeArchive::BlockEntry, offset), 0xfffffff0u),
+                                  "block offset past the payload");
+    TestAssertService::assertTrue(rejectedWith(firstBlock + offsetof(EdgeArchive::BlockEntry, edges), 0xfffffff0u),
+                                  "edges beyond block bytes");
+    std::filesystem::remove(path);
+
+    TestAssertService::cleanUp(fn_name);
+}
+
+#endif  // GRAPH_TESTS
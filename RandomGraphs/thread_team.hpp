@@ -0,0 +1,104 @@
+#if !defined(THREAD_TEAM)
+#define THREAD_TEAM
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @class ThreadTeam
+ * @brief A fixed group of threads that run the same task together, many times.
+ *
+ * The calling thread is member 0 and `size - 1` workers are started once and parked
+ * between tasks, so handing out a short task costs a wake-up instead of a thread start.
+ */
+class ThreadTeam {
+public:
+    /**
+     * @brief Starts a team of `size` members, the calling thread included.
+     * @param size The number of members, values below 1 mean 1.
+     */
+    ThreadTeam(int size) {
+        members = size < 1 ? 1 : size;
+        for (int id = 1; id < members; id++) workers.emplace_back([this, id] { work(id); });
+    }
+
+    ~ThreadTeam() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+            generation++;
+        }
+        wake.notify_all();
+        for (auto &worker : workers) worker.join();
+    }
+
+    ThreadTeam(const ThreadTeam &) = delete;
+    ThreadTeam &operator=(const ThreadTeam &) = delete;
+
+    /**
+     * @brief Runs task(memberID) on every member and returns when all of them are done.
+     * @param task The work of one member, called with IDs 0 .. size() - 1.
+     */
+    void run(const std::function<void(int)> &task) {
+        if (members == 1) {
+            task(0);
+            return;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            current = &task;
+            running = members - 1;
+            generation++;
+        }
+        wake.notify_all();
+
+        task(0);
+
+        std::unique_lock<std::mutex> lock(mutex);
+        finished.wait(lock, [this] { return running == 0; });
+        current = nullptr;
+    }
+
+    int size() const {
+        return members;
+    }
+
+private:
+    int members;
+    std::vector<std::thread> workers;
+
+    std::mutex mutex;
+    std::condition_variable wake, finished;
+    const std::function<void(int)> *current = nullptr;
+    long long generation = 0;
+    int running = 0;
+    bool stopping = false;
+
+    void work(int id) {
+        long long seen = 0;
+
+        while (true) {
+            const std::function<void(int)> *task;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                wake.wait(lock, [&] { return generation != seen; });
+                seen = generation;
+                if (stopping)
+                    return;
+                task = current;
+            }
+
+            (*task)(id);
+
+            std::lock_guard<std::mutex> lock(mutex);
+            if (--running == 0)
+                finished.notify_one();
+        }
+    }
+};
+
+#endif  // THREAD_TEAM
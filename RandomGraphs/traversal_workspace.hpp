@@ -0,0 +1,123 @@
+#if !defined(TRAVERSAL_WORKSPACE)
+#define TRAVERSAL_WORKSPACE
+
+#include <algorithm>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+/**
+ * @class TraversalWorkspace
+ * @brief Scratch memory for bounded BFS traversals, allocated once and reused by every call.
+ *
+ * Visited marks are generation stamped: a node is visited only when its stamp equals the
+ * current generation, so starting a traversal is one increment instead of clearing n marks.
+ * The frontier is a ring buffer of (node, distance) pairs that keeps its capacity between
+ * traversals. A traversal therefore only pays for the nodes it actually touches.
+ *
+ * One workspace serves one traversal at a time, threads need a workspace each.
+ */
+class TraversalWorkspace {
+public:
+    /**
+     * @brief Constructs a workspace for node IDs in [0, n].
+     * @param n The largest node ID.
+     */
+    TraversalWorkspace(int n = 0) {
+        resize(n);
+    }
+
+    /**
+     * @brief Makes room for node IDs in [0, n], dropping all visited marks.
+     * @param n The largest node ID.
+     */
+    void resize(int n) {
+        visitedGeneration.assign(n + 1, 0);
+        generation = 0;
+    }
+
+    /**
+     * @brief Starts a new traversal, every node becomes unvisited and the frontier empty.
+     */
+    void beginTraversal() {
+        generation++;
+
+        // the stamps wrapped around, old marks could look current again
+        if (generation == 0) {
+            std::fill(visitedGeneration.begin(), visitedGeneration.end(), 0);
+            generation = 1;
+        }
+
+        head = 0;
+        count = 0;
+    }
+
+    /**
+     * @brief Marks a node as visited in the current traversal.
+     * @param node The node to mark.
+     * @return True if the node was not visited before, false otherwise.
+     */
+    bool visit(int node) {
+        if (visitedGeneration[node] == generation)
+            return false;
+        visitedGeneration[node] = generation;
+        return true;
+    }
+
+    bool isVisited(int node) const {
+        return visitedGeneration[node] == generation;
+    }
+
+    /**
+     * @brief Appends a node to the back of the frontier, growing the ring when it is full.
+     * @param node The node to enqueue.
+     * @param distance The distance of the node from the traversal source.
+     */
+    void push(int node, int distance) {
+        if (count == ring.size())
+            grow();
+
+        ring[(head + count) & (ring.size() - 1)] = {node, distance};
+        count++;
+    }
+
+    const std::pair<int, int> &front() const {
+        return ring[head];
+    }
+
+    void pop() {
+        head = (head + 1) & (ring.size() - 1);
+        count--;
+    }
+
+    bool empty() const {
+        return count == 0;
+    }
+
+    size_t size() const {
+        return count;
+    }
+
+private:
+    std::vector<uint32_t> visitedGeneration;
+    uint32_t generation = 0;
+
+    std::vector<std::pair<int, int>> ring;  // capacity is always a power of two
+    size_t head = 0, count = 0;
+
+    /**
+     * @brief Doubles the ring capacity, unrolling the live entries to the front.
+     */
+    void grow() {
+        size_t capacity = ring.empty() ? 64 : ring.size() * 2;
+        std::vector<std::pair<int, int>> unrolled(capacity);
+
+        for (size_t i = 0; i < count; i++)
+            unrolled[i] = ring[(head + i) & (ring.size() - 1)];
+
+        ring.swap(unrolled);
+        head = 0;
+    }
+};
+
+#endif  // TRAVERSAL_WORKSPACE
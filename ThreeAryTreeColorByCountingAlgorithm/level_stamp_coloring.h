@@ -0,0 +1,195 @@
+#if !defined(LEVEL_STAMP_COLORING)
+#define LEVEL_STAMP_COLORING
+
+#include <algorithm>
+#include <vector>
+
+using namespace std;
+
+/**
+ * Positions start, start + stride, ..., start + (count - 1) * stride within one level.
+ */
+class PositionProgression {
+public:
+    long long start, stride, count;
+
+    long long last() const {
+        return start + (count - 1) * stride;
+    }
+
+    /**
+     * True if a position of the progression lies in [from, to).
+     */
+    bool intersects(long long from, long long to) const {
+        if (from <= start)
+            return start < to;
+        if (count == 1 or from > last())
+            return false;
+
+        long long steps = (from - start + stride - 1) / stride;
+        return start + steps * stride < to;
+    }
+};
+
+/**
+ * @class LevelStampColoring
+ * @brief Approximate packing coloring of a complete k-ary tree, stamped level by level without any BFS.
+ *
+ * Makes the same choices as Graph::approximatePackingColor: every other level from the bottom
+ * takes color 1, then the remaining levels are colored bottom up, left to right, each node
+ * taking the smallest color in [1, 2 * levels + 2] that no node within that distance holds,
+ * or a unique color when none fits.
+ *
+ * A node is addressed by its depth and its position within the level. The distance between
+ * two nodes follows from their lowest common ancestor, which is position arithmetic, so
+ * "is color c held within distance c" is one range query per depth that holds c. The holders
+ * of a color at one depth are kept as arithmetic progressions: levels of a complete tree are
+ * colored in periodic patterns, so a whole level is usually a handful of progressions and
+ * trees far too large to store a color per node can be colored and counted.
+ */
+template <int K>
+class LevelStampColoring {
+    static_assert(K >= 2, "a k-ary tree needs at least two children per node");
+
+public:
+    int levels;
+    long long maxNodes = 0;
+    vector<long long> levelWidth;  // nodes at every depth, root first
+
+    vector<long long> colorCount;     // nodes holding every color, index 0 counts the uniquely colored ones
+    long long uniquelyUsedColors = 0;
+
+    LevelStampColoring(int levelCount) {
+        levels = levelCount;
+
+        long long width = 1;
+        for (int depth = 0; depth < levels; depth++, width *= K) {
+            levelWidth.push_back(width);
+            maxNodes += width;
+        }
+    }
+
+    /**
+     * Colors the whole tree, the result is read with colorOf and colorCount.
+     * @return The number of uniquely used colors.
+     */
+    long long approximatePackingColor() {
+        int maxReusableColorUpperBound = levels * 2 + 2;
+        int lastExploredColor = (int)std::min<long long>(maxReusableColorUpperBound, maxNodes - 1);
+
+        // color 1 is stamped even when no color may be explored, as the BFS path does
+        holders.assign(std::max(lastExploredColor, 1) + 1, vector<vector<PositionProgression>>(levels));
+        colorCount.assign(holders.size(), 0);
+        uniquelyUsedColors = 0;
+
+        // maximize the number of nodes to be colored with color 1, starting from the last level
+        for (int depth = levels - 1; depth >= 0; depth -= 2) {
+            holders[1][depth].push_back({0, 1, levelWidth[depth]});
+            colorCount[1] += levelWidth[depth];
+        }
+
+        for (int depth = levels - 2; depth >= 0; depth -= 2) {
+            for (long long position = 0; position < levelWidth[depth]; position++) {
+                int color = smallestPackableColor(depth, position, lastExploredColor);
+
+                if (color != 0) {
+                    stamp(color, depth, position);
+                } else {
+                    colorCount[0]++;
+                    if (lastExploredColor == maxReusableColorUpperBound)
+                        uniquelyUsedColors++;
+                }
+            }
+        }
+
+        return uniquelyUsedColors;
+    }
+
+    /**
+     * The color of the node at the given depth and position, 0 if it holds a unique color.
+     */
+    int colorOf(int depth, long long position) const {
+        for (int color = 1; color < (int)holders.size(); color++) {
+            if (isHeldIn(color, depth, position, position + 1))
+                return color;
+        }
+        return 0;
+    }
+
+    /**
+     * The number of progressions that describe the coloring, its memory footprint.
+     */
+    long long progressionCount() const {
+        long long total = 0;
+        for (auto &byDepth : holders)
+            for (auto &progressions : byDepth) total += progressions.size();
+        return total;
+    }
+
+private:
+    // holders[color][depth], sorted by position and disjoint
+    vector<vector<vector<PositionProgression>>> holders;
+
+    int smallestPackableColor(int depth, long long position, int lastExploredColor) const {
+        for (int color = 1; color <= lastExploredColor; color++) {
+            if (not isHeldWithin(color, depth, position, color))
+                return color;
+        }
+        return 0;
+    }
+
+    /**
+     * True if a node within distance radius of (depth, position) holds color.
+     */
+    bool isHeldWithin(int color, int depth, long long position, int radius) const {
+        for (int other = std::max(0, depth - radius); other <= std::min(levels - 1, depth + radius); other++) {
+            if (holders[color][other].empty())
+                continue;
+
+            // nodes at depth `other` within radius share an ancestor at depth >= ancestorDepth
+            int ancestorDepth = std::max(0, (depth + other - radius + 1) / 2);
+            if (ancestorDepth > std::min(depth, other))
+                continue;
+
+            long long ancestor = position / power(depth - ancestorDepth);
+            long long subtreeWidth = power(other - ancestorDepth);
+            if (isHeldIn(color, other, ancestor * subtreeWidth, (ancestor + 1) * subtreeWidth))
+                return true;
+        }
+        return false;
+    }
+
+    bool isHeldIn(int color, int depth, long long from, long long to) const {
+        auto &progressions = holders[color][depth];
+
+        // the first progression that does not end before from, later ones start after it ends
+        auto candidate = std::partition_point(progressions.begin(), progressions.end(),
+                                              [from](const PositionProgression &p) { return p.last() < from; });
+        return candidate != progressions.end() and candidate->intersects(from, to);
+    }
+
+    void stamp(int color, int depth, long long position) {
+        colorCount[color]++;
+
+        auto &progressions = holders[color][depth];
+        if (not progressions.empty()) {
+            PositionProgression &last = progressions.back();
+            if (last.count == 1) {
+                last.stride = position - last.start;
+                last.count = 2;
+                return;
+            }
+            if (position == last.last() + last.stride) {
+                last.count++;
+                return;
+            }
+        }
+        progressions.push_back({position, 1, 1});
+    }
+
+    long long power(int exponent) const {
+        return levelWidth[exponent];
+    }
+};
+
+#endif // LEVEL_STAMP_COLORING
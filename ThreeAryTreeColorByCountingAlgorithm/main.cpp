@@ -19,69 +19,99 @@
 
 #include "color.h"
 #include "graph.h"
+#include "../common/mapped_input.h"
+#include "level_stamp_coloring.h"
 #include "tree.h"
 
 using namespace std;
 
+// true stamps the coloring level by level without BFS, the only way to color trees of 20+ levels.
+// both paths produce the same coloring.
+#define STAMP_LEVELS true
+// trees up to this many levels are also colored with BFS and compared node by node when stamping
+#define VALIDATE_STAMP_UP_TO_LEVELS 9
+
 void fileIO() {
-    freopen("input.txt", "r", stdin);
+    // input.txt is mapped by MappedInput, only the output goes through a stream
     freopen("output.txt", "w", stdout);
 }
 
-void solve() {
-
-    vector<int> v;
+void solve(MappedInput &input) {
 
-    int levels;
-    cin >> levels;
+    int levels = 0;
+    input >> levels;
 
     std::cout << "[TOTAL LEVELS]: " << levels << std::endl;
 
-    int maxNodeID = 0;
-    
-    for (int i = 0; i < levels; i++) {
-        maxNodeID += pow(3, i);
-    }
-
-    cout << "TOTAL ORIGINAL NODES: " << maxNodeID << endl;
-
-    for (int i = 1; i <= maxNodeID; i++) {
-        v.push_back(i);
-    }
-
-    // For arbitary tree
-    // 1. find a suitable root and assign root
-    // 2. format the tree into a hiararchial structure
-    // 3. Tree* root = TreeServices::createTreeFromStream();
-    Tree *tree = TreeServices::createTreeFromVector(v);
-    
-    // For custom trees we can also
-    // directly build the graph as Graph G(maxNodeID);
-    // for (auto edge : edgeList) g.add_edge(edge);
-    Graph g(maxNodeID);
-
-    // updates the graph in-place with the equivalent tree.
-    GraphServices::createGraphWhileLevelOrderTraversalOfEquivalentTree(tree, g);
-
-    auto procedure_start = std::chrono::high_resolution_clock::now();
-    // given the tree structure do approximatePackingColor on graph g.
-    int uniquelyUsedColors = g.approximatePackingColor(tree);
-    auto procedure_end = std::chrono::high_resolution_clock::now();
-
-    std::chrono::duration<float> duration = procedure_end - procedure_start;
-    cout << "[TOTAL TIME]: " << duration.count() << " seconds" << endl;
+    long long totalNodes = ImplicitKaryTree<3>::nodesInLevels(levels);
 
-    vector<Color> colors = g.colors;
+    cout << "TOTAL ORIGINAL NODES: " << totalNodes << endl;
 
     int maxColor = -1;
-
-    map<int, int> colorCounter;
-
-    for (int i = 1; i < colors.size(); i++) {
-        // if ((i + 1) % 3 == 0) cout << endl;
-        maxColor = std::max(colors[i].colorID, maxColor);
-        // cout << "[NODE]: " << i << " color -> " << colors[i] << endl;
-        colorCounter[colors[i].colorID]++;
+    long long uniquelyUsedColors;
+    map<int, long long> colorCounter;
+
+    if (STAMP_LEVELS) {
+        LevelStampColoring<3> stamped(levels);
+
+        auto procedure_start = std::chrono::high_resolution_clock::now();
+        uniquelyUsedColors = stamped.approximatePackingColor();
+        auto procedure_end = std::chrono::high_resolution_clock::now();
+
+        std::chrono::duration<float> duration = procedure_end - procedure_start;
+        cout << "[TOTAL TIME]: " << duration.count() << " seconds" << endl;
+
+        for (int color = 0; color < (int)stamped.colorCount.size(); color++) {
+            if (stamped.colorCount[color] == 0)
+                continue;
+            maxColor = std::max(color, maxColor);
+            colorCounter[color] = stamped.colorCount[color];
+        }
+
+        if (levels <= VALIDATE_STAMP_UP_TO_LEVELS) {
+            ImplicitKaryTree<3> tree(totalNodes);
+            Graph g(tree);
+            g.approximatePackingColor(tree);
+
+            long long mismatches = 0;
+            int node = 1;
+            for (int depth = 0; depth < levels; depth++) {
+                for (long long position = 0; position < stamped.levelWidth[depth]; position++, node++)
+                    mismatches += stamped.colorOf(depth, position) != g.colors[node].colorID;
+            }
+            cout << "[VALIDATION]: " << mismatches << " nodes colored differently by BFS" << endl;
+        }
+    } else {
+        int maxNodeID = totalNodes;
+
+        // The complete tree is numbered 1 .. maxNodeID in level order, so its
+        // structure is computed on the fly instead of linking Tree nodes.
+        //
+        // For arbitary tree
+        // 1. find a suitable root and assign root
+        // 2. format the tree into a hiararchial structure
+        // 3. Tree* root = TreeServices::createTreeFromStream();
+        // 4. build Graph g(maxNodeID) with createGraphWhileLevelOrderTraversalOfEquivalentTree
+        //    and call g.approximatePackingColor(root).
+        ImplicitKaryTree<3> tree(maxNodeID);
+        Graph g(tree);
+
+        auto procedure_start = std::chrono::high_resolution_clock::now();
+        // given the tree structure do approximatePackingColor on graph g.
+        uniquelyUsedColors = g.approximatePackingColor(tree);
+        auto procedure_end = std::chrono::high_resolution_clock::now();
+
+        std::chrono::duration<float> duration = procedure_end - procedure_start;
+        cout << "[TOTAL TIME]: " << duration.count() << " seconds" << endl;
+
+        vector<Color> colors = g.colors;
+
+        for (int i = 1; i < colors.size(); i++) {
+            // if ((i + 1) % 3 == 0) cout << endl;
+            maxColor = std::max(colors[i].colorID, maxColor);
+            // cout << "[NODE]: " << i << " color -> " << colors[i] << endl;
+            colorCounter[colors[i].colorID]++;
+        }
     }
 
     cout << "[MAXCOLOR] used: " << maxColor << "\n";
@@ -92,7 +122,7 @@ void solve() {
 
     cout << "uniquelyUsedColors: " << uniquelyUsedColors << endl;
     
-    int totalColorsUsed = maxColor + uniquelyUsedColors;
+    long long totalColorsUsed = maxColor + uniquelyUsedColors;
     cout << "Total Colors Used = " << totalColorsUsed << endl;
 
     std::cout << "\n";
@@ -102,11 +132,12 @@ void solve() {
 
 int main() {
     fileIO();
+    MappedInput input("input.txt");
+
+    int testcases = 0;
+    input >> testcases;
 
-    int testcases;
-    cin >> testcases;
-    
     while (testcases--) {
-        solve();
+        solve(input);
     }
 }
\ No newline at end of file
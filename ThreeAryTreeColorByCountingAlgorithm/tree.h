@@ -3,6 +3,8 @@
 
 #include <string.h>
 
+#include <algorithm>
+#include <array>
 #include <chrono>
 #include <iostream>
 #include <queue>
@@ -10,6 +12,8 @@
 #include <set>
 #include <vector>
 
+#include "../common/tree_arena.h"
+
 using namespace std;
 
 // Tree Definition
@@ -24,6 +28,13 @@ public:
         middle = nullptr;
         right = nullptr;
     }
+
+    /**
+     * The child pointers, for code that walks or relinks any kind of tree node.
+     */
+    array<Tree **, 3> children() {
+        return {&left, &middle, &right};
+    }
 };
 
 namespace TreeServices {
@@ -36,12 +47,17 @@ void inOrderTraversalOnAThreeAryTree(Tree *root) {
     }
 }
 
-Tree *createTreeFromVector(vector<int> v) {
+/**
+ * Links the IDs of v into a complete tree in level order, its nodes are owned by arena.
+ */
+Tree *createTreeFromVector(const vector<int> &v, TreeArena<Tree> &arena) {
     if (v.size() == 0)
         return nullptr;
 
+    arena.reserve(v.size());
+
     int root = v[0];
-    Tree *treeRoot = new Tree(root);
+    Tree *treeRoot = arena.create(root);
 
     queue<Tree *> q;
     q.push(treeRoot);
@@ -51,17 +67,17 @@ Tree *createTreeFromVector(vector<int> v) {
         Tree *thisNode = q.front();
         q.pop();
 
-        thisNode->left = new Tree(v[i++]);
+        thisNode->left = arena.create(v[i++]);
         q.push(thisNode->left);
         if (i >= v.size())
             break;
 
-        thisNode->middle = new Tree(v[i++]);
+        thisNode->middle = arena.create(v[i++]);
         q.push(thisNode->middle);
         if (i >= v.size())
             break;
 
-        thisNode->right = new Tree(v[i++]);
+        thisNode->right = arena.create(v[i++]);
         q.push(thisNode->right);
         if (i >= v.size())
             break;
@@ -134,7 +150,12 @@ vector<vector<Tree *>> buildLevelOrderTraversalStructureWithTreeReference(Tree *
     return levelOrderTraversal;
 }
 
-int randomizedTreePruningRuntime(Tree *root) {
+/**
+ * Randomly cuts the children of nodes, bottom layer first, then frees the cut subtrees by
+ * compacting the remaining tree in arena, root is updated to its new address.
+ * @return The number of children cut off.
+ */
+int randomizedTreePruningRuntime(Tree *&root, TreeArena<Tree> &arena) {
     int totalRemovedNodes = 0;
 
     const int prob_lower_bound = 1;
@@ -182,6 +203,7 @@ int randomizedTreePruningRuntime(Tree *root) {
         }
     }
 
+    root = arena.compact(root);
     return totalRemovedNodes;
 }
 };  // namespace TreeServices
@@ -2,7 +2,10 @@
 #define GRAPHS
 
 #include "color.h"
+#include "../common/implicit_tree.h"
+#include "../common/level_order_stream.h"
 #include "tree.h"
+#include <algorithm>
 #include <iostream>
 #include <queue>
 #include <set>
@@ -32,6 +35,30 @@ public:
         colors = vector<Color>(n + 1, Color(0));
     }
 
+    /**
+     * A graph over the nodes of an implicit tree, no edge is stored.
+     * Pass the tree to approximatePackingColor.
+     */
+    template <int K>
+    Graph(const ImplicitKaryTree<K> &tree) {
+        maxNodes = tree.maxNodes;
+        colors = vector<Color>(maxNodes + 1, Color(0));
+    }
+
+    /**
+     * A graph over a tree read from a level-order stream, which keeps the adjacency itself.
+     * Pass the tree to approximatePackingColor.
+     */
+    template <int K>
+    Graph(const LevelOrderKaryTree<K> &tree) {
+        maxNodes = tree.maxNodeID;
+        colors = vector<Color>(maxNodes + 1, Color(0));
+    }
+
+    const vector<int> &neighbors(int node) const {
+        return adj_list[node];
+    }
+
     void add_edge(int from, int to) {
         adj_list[from].push_back(to);
         adj_list[to].push_back(from);
@@ -83,68 +110,122 @@ public:
     }
 
     void greedilyMaximizeNodesWithColorOne(Tree *root) {
+        buildLevelOrderTraversalStructure(root);
+        greedilyMaximizeNodesWithColorOne(levelOrderTraversal);
+    }
+
+    template <typename Levels>
+    void greedilyMaximizeNodesWithColorOne(const Levels &levelOrder) {
         // maximize the number of nodes to be colored with color 1
         // to do that start with coloring from the last level (most node)
         // in any layer.
 
-        buildLevelOrderTraversalStructure(root);
-
-        int levels = levelOrderTraversal.size();
+        int levels = levelOrder.size();
         for (int i = levels - 1; i >= 0; i -= 2) {
-            for (auto candidate : levelOrderTraversal[i]) {
+            for (auto candidate : levelOrder[i]) {
                 colors[candidate] = Color(1);
             }
         }
     }
 
     int approximatePackingColor(Tree *root) {
+        buildLevelOrderTraversalStructure(root);
+        return approximatePackingColor(*this, levelOrderTraversal);
+    }
+
+    /**
+     * Colors an implicit k-ary tree, its structure is computed on the fly and never stored.
+     */
+    template <int K>
+    int approximatePackingColor(const ImplicitKaryTree<K> &tree) {
+        return approximatePackingColor(tree, tree.levels);
+    }
+
+    /**
+     * Colors a tree read from a level-order stream through its CSR adjacency.
+     */
+    template <int K>
+    int approximatePackingColor(const LevelOrderKaryTree<K> &tree) {
+        return approximatePackingColor(tree, tree.levels);
+    }
+
+    /**
+     * @param topology Provides neighbors(node), this graph, an implicit or a streamed tree.
+     * @param levelOrder The nodes of every level, root first.
+     */
+    template <typename Topology, typename Levels>
+    int approximatePackingColor(const Topology &topology, const Levels &levelOrder) {
         // maximize the number of nodes to be colored with color 1
-        greedilyMaximizeNodesWithColorOne(root);
+        greedilyMaximizeNodesWithColorOne(levelOrder);
 
         // start from the last uncolored level
-        int lastUncoloredLevel = levelOrderTraversal.size() - 2;
+        int lastUncoloredLevel = (int)levelOrder.size() - 2;
 
         for (int level = lastUncoloredLevel; level >= 0; level -= 2) {
-            vector<int> thisLevel = levelOrderTraversal[level];
-            for (auto candidate : thisLevel) {
+            for (auto candidate : levelOrder[level]) {
                 if (colors[candidate].colorID != 0) continue;
-                // we need to color this candidate.
-                // for each node do a bfs to find if it is colorable with color = color
-                int currentlyExploringColor = 1;
-
-                set<int> colorsFoundWhileTravelling;
 
-                while (currentlyExploringColor < maxNodes) {
-                    // from color = 2 to color = MaxNodes
-                    // check if it is possible to color with this node
-
-                    // cout << "[CANDIDATE]: " << candidate << " currentlyExploringColor = " << currentlyExploringColor << endl;
-
-                    if (colorsFoundWhileTravelling.count(currentlyExploringColor) == 0) {
-                        colorsFoundWhileTravelling = travelForColor(Color(currentlyExploringColor), candidate);
+                int color = ballScanForColor(topology, candidate, maxNodes - 1);
+                if (color != 0)
+                    colors[candidate] = Color(color);
+            }
+        }
 
-                        // cout << "calling again for currentlyExploringColor = " << currentlyExploringColor << endl;
+        return -1;
+    }
 
-                        // if we don't find the current color then we color it with
-                        // currentlyExploringColor and gtfo
-                        if (colorsFoundWhileTravelling.count(currentlyExploringColor) == 0) {
-                            // cout << "*************" << endl;
-                            // for (auto i : colorsFoundWhileTravelling) { cout << i << " ";}
-                            // cout << "\n*************" << endl;
+    /**
+     * @brief Finds the smallest color a candidate can take using one bounded BFS.
+     *
+     * The ball around the candidate is grown one BFS layer at a time and, for every color,
+     * the nearest distance at which it appears is recorded. The candidate takes the smallest
+     * color c whose nearest distance is greater than c, so while color c is examined the ball
+     * only needs radius c. Every node of the final ball is visited exactly once.
+     *
+     * @param candidate The node to be colored.
+     * @param lastExploredColor The largest color that may be assigned.
+     * @return The smallest packable color, or 0 if no color in [1, lastExploredColor] fits.
+     */
+    int ballScanForColor(int candidate, int lastExploredColor) {
+        return ballScanForColor(*this, candidate, lastExploredColor);
+    }
 
-                            colors[candidate] = currentlyExploringColor;
-                            break;
+    /**
+     * Same as ballScanForColor(candidate, lastExploredColor) over any tree topology.
+     * The ball only grows away from the node each frontier node was reached from, which
+     * is enough in a tree, so no visited mark is kept and a scan costs only its ball.
+     */
+    template <typename Topology>
+    int ballScanForColor(const Topology &topology, int candidate, int lastExploredColor) {
+        beginScan();
+
+        frontier.assign(1, {candidate, 0});
+        recordColor(colors[candidate].colorID, 0);
+
+        int radius = 0;
+        for (int color = 1; color <= lastExploredColor; color++) {
+            // grow the ball until it holds every node within distance color
+            while (radius < color and not frontier.empty()) {
+                radius++;
+                nextFrontier.clear();
+
+                for (auto [node, from] : frontier) {
+                    for (auto nbr : topology.neighbors(node)) {
+                        if (nbr != from) {
+                            nextFrontier.push_back({nbr, node});
+                            recordColor(colors[nbr].colorID, radius);
                         }
                     }
-
-                    // if it is found this means we found the currentlyExploringColor
-                    // at a distance lower than the (int) currentlyExploringColor.
-                    currentlyExploringColor++;
                 }
+
+                frontier.swap(nextFrontier);
             }
+
+            if (colorGeneration[color] != generation or nearestDistanceOfColor[color] > color)
+                return color;
         }
 
-        return -1;
+        return 0;
     }
 
     set<int> travelForColor(Color clr, int node) {
@@ -184,6 +265,41 @@ public:
 
         return colorsFoundWhileVisiting;
     }
+
+private:
+    // scratch of ballScanForColor, allocated on the first scan: a color counts as seen in the
+    // current scan only when its stamp equals generation, so a scan costs its ball and not maxNodes
+    vector<unsigned> colorGeneration;
+    vector<int> nearestDistanceOfColor; // valid where colorGeneration is current
+    unsigned generation = 0;
+    vector<pair<int, int>> frontier, nextFrontier; // node and the node it was reached from
+
+    void beginScan() {
+        // every color is below colors.size(), the node count plus one
+        if (colorGeneration.size() != colors.size()) {
+            colorGeneration.assign(colors.size(), 0);
+            nearestDistanceOfColor.assign(colors.size(), 0);
+            generation = 0;
+        }
+
+        generation++;
+
+        // the stamps wrapped around, old marks could look current again
+        if (generation == 0) {
+            std::fill(colorGeneration.begin(), colorGeneration.end(), 0);
+            generation = 1;
+        }
+    }
+
+    /**
+     * Keeps the first, and so nearest, distance a color is found at during a scan.
+     */
+    void recordColor(int color, int distance) {
+        if (colorGeneration[color] != generation) {
+            colorGeneration[color] = generation;
+            nearestDistanceOfColor[color] = distance;
+        }
+    }
 };
 
 std::ostream &operator<<(std::ostream &stream, Graph &g) {
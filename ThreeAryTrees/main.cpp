@@ -16,73 +16,114 @@
 #include <vector>
 #include <map>
 
+#include "../common/buffered_output.h"
 #include "color.h"
 #include "graph.h"
+#include "../common/level_order_stream.h"
+#include "../common/mapped_input.h"
 #include "tree.h"
 
 using namespace std;
 
+// true writes the colors to colors.bin, a uint32 per node, instead of a text line per node
+#define BINARY_COLOR_DUMP false
+
 void fileIO() {
-    freopen("input.txt", "r", stdin);
+    // input.txt is mapped by MappedInput, only the output goes through a stream
     freopen("output.txt", "w", stdout);
 }
 
 int main() {
 
     fileIO();
+    MappedInput input("input.txt");
 
-    vector<int> v;
-    int levels;
-    cin >> levels;
+    int levels = 0;
+    input >> levels;
 
-    int maxNodeID;
-    cin >> maxNodeID;
+    int maxNodeID = 0;
+    input >> maxNodeID;
 
-    levels++;
+    if (not input) {
+        cout << "[ERROR]: input.txt must start with the number of levels and the largest node ID" << endl;
+        return 1;
+    }
 
-    while (levels--) {
-        char a[1250000];
-        cin.getline(a, 1250000);
+    vector<Color> colors;
+    std::chrono::duration<float> duration;
+
+    // nodes numbered 1 .. n in level order form an implicit tree, its neighbors are computed
+    auto colorImplicitTree = [&](int nodes) {
+        ImplicitKaryTree<3> tree(nodes);
+        Graph g(tree);
+
+        auto procedure_start = std::chrono::high_resolution_clock::now();
+        g.approximatePackingColor(tree);
+        duration = std::chrono::high_resolution_clock::now() - procedure_start;
+
+        colors = g.colors;
+    };
+
+    if (input.consume("implicit")) {
+        // the generator's implicit mode writes only the header and the arity, the tree is the
+        // complete one numbered 1 .. maxNodeID and its IDs are never materialized
+        int arity = 0;
+        input >> arity;
+        if (arity != 3) {
+            cout << "[ERROR]: the input is an implicit tree of arity " << arity << ", not a 3-ary tree" << endl;
+            return 1;
+        }
 
-        // String TOKENIZER to get all the numbers and convert them into integers
-        // then push it into the vector
-        char *ans = strtok(a, " ");
-        while (ans != NULL) {
-            v.push_back(stoi(ans));
-            ans = strtok(NULL, " ");
+        colorImplicitTree(maxNodeID);
+    } else {
+        // IDs numbered 1 .. n are only counted as they are read, any other order is read once
+        // and written straight into the CSR adjacency of the tree
+        LevelOrderIDs stream = readLevelOrderIDs(input);
+
+        if (stream.isLevelOrderNumbered()) {
+            colorImplicitTree(stream.count);
+        } else {
+            LevelOrderKaryTree<3> streamed(std::move(stream.ids), maxNodeID);
+            if (not streamed) {
+                cout << "[ERROR]: node IDs must be distinct and between 1 and " << maxNodeID << endl;
+                return 1;
+            }
+
+            Graph g(streamed);
+
+            auto procedure_start = std::chrono::high_resolution_clock::now();
+            // given the tree structure do approximatePackingColor on graph g.
+            g.approximatePackingColor(streamed);
+            duration = std::chrono::high_resolution_clock::now() - procedure_start;
+
+            colors = g.colors;
         }
     }
 
-    Tree *tree = TreeServices::createTreeFromVector(v);
-    Graph g(maxNodeID);
-
-    GraphServices::createGraphWhileLevelOrderTraversal(tree, g);
-
-    auto procedure_start = std::chrono::high_resolution_clock::now();
-    // given the tree structure do approximatePackingColor on graph g.
-    g.approximatePackingColor(tree);
-    auto procedure_end = std::chrono::high_resolution_clock::now();
-
-    std::chrono::duration<float> duration = procedure_end - procedure_start;
-    cout << "[TOTAL TIME]: " << duration.count() << " seconds" << endl;
-
-    vector<Color> colors = g.colors;
+    // one line per node, formatted into a single buffer instead of flushing every endl
+    BufferedOutput out;
+    out << "[TOTAL TIME]: " << duration.count() << " seconds\n";
 
     int maxColor = -1;
 
     map<int, int> colorCounter;
 
     for (int i = 1; i < colors.size(); i++) {
-        if ((i + 1) % 3 == 0) cout << endl;
         maxColor = std::max(colors[i].colorID, maxColor);
-        cout << "[NODE]: " << i << " color -> " << colors[i] << endl;
         colorCounter[colors[i].colorID]++;
+
+        if (BINARY_COLOR_DUMP) continue;
+        if ((i + 1) % 3 == 0) out << '\n';
+        out << "[NODE]: " << i << " color -> " << colors[i].colorID << '\n';
     }
 
-    cout << "[MAXCOLOR] used: " << maxColor << "\n";
+    if (BINARY_COLOR_DUMP and not writeColorDump("colors.bin", colors))
+        out << "[ERROR]: could not write colors.bin\n";
+
+    out << "[MAXCOLOR] used: " << maxColor << "\n";
 
     for (auto counter : colorCounter) {
-        cout << "color: " << counter.first << " -> " << counter.second << "\n";
+        out << "color: " << counter.first << " -> " << counter.second << "\n";
     }
 
     return 0;
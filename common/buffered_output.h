@@ -0,0 +1,156 @@
+#if !defined(BUFFERED_OUTPUTS)
+#define BUFFERED_OUTPUTS
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+using namespace std;
+
+/**
+ * @class BufferedOutput
+ * @brief Collects output in one large buffer and hands it to the file in a few big writes.
+ *
+ * Integers are formatted by hand into the buffer, nothing is flushed per line the way endl
+ * does, so dumping a color per node costs about as much as copying the digits. Everything left
+ * is written when the output is flushed or destroyed. Anything else writing to the same file
+ * must wait for a flush, text written in between would land before the buffered part.
+ */
+class BufferedOutput {
+public:
+    static constexpr size_t DEFAULT_CAPACITY = 1 << 22;
+
+    explicit BufferedOutput(FILE *file = stdout, size_t capacity = DEFAULT_CAPACITY) : file(file) {
+        buffer.resize(std::max<size_t>(capacity, 64));
+    }
+
+    BufferedOutput(const BufferedOutput &) = delete;
+    BufferedOutput &operator=(const BufferedOutput &) = delete;
+
+    ~BufferedOutput() {
+        flush();
+    }
+
+    BufferedOutput &operator<<(string_view text) {
+        write(text.data(), text.size());
+        return *this;
+    }
+
+    BufferedOutput &operator<<(char c) {
+        if (used == buffer.size())
+            drain();
+        buffer[used++] = c;
+        return *this;
+    }
+
+    template <typename Integer>
+        requires(std::is_integral_v<Integer> and not std::is_same_v<Integer, char> and not std::is_same_v<Integer, bool>)
+    BufferedOutput &operator<<(Integer value) {
+        // 20 digits and a sign hold any 64 bit integer
+        if (buffer.size() - used < 21)
+            drain();
+
+        char digits[20];
+        int count = 0;
+        using Unsigned = std::make_unsigned_t<Integer>;
+        Unsigned magnitude = (Unsigned)value;
+        if constexpr (std::is_signed_v<Integer>) {
+            if (value < 0) {
+                buffer[used++] = '-';
+                magnitude = (Unsigned)0 - magnitude;
+            }
+        }
+
+        do {
+            digits[count++] = (char)('0' + magnitude % 10);
+            magnitude /= 10;
+        } while (magnitude != 0);
+
+        while (count > 0) buffer[used++] = digits[--count];
+        return *this;
+    }
+
+    /**
+     * Floating point values are printed the way cout prints them by default, 6 significant digits.
+     */
+    BufferedOutput &operator<<(double value) {
+        char text[32];
+        int length = snprintf(text, sizeof(text), "%g", value);
+        write(text, std::min<size_t>(length, sizeof(text) - 1));
+        return *this;
+    }
+
+    /**
+     * Appends raw bytes, e.g. a binary dump.
+     */
+    void write(const void *bytes, size_t count) {
+        const char *data = static_cast<const char *>(bytes);
+        if (count > buffer.size() - used) {
+            drain();
+            // larger than the whole buffer, goes to the file directly
+            if (count >= buffer.size()) {
+                fwrite(data, 1, count, file);
+                return;
+            }
+        }
+        std::memcpy(buffer.data() + used, data, count);
+        used += count;
+    }
+
+    /**
+     * Appends the bytes of a value in native byte order.
+     */
+    template <typename Value>
+        requires std::is_trivially_copyable_v<Value>
+    void writeBinary(const Value &value) {
+        write(&value, sizeof(value));
+    }
+
+    /**
+     * Writes everything buffered and flushes the file.
+     */
+    void flush() {
+        drain();
+        fflush(file);
+    }
+
+private:
+    void drain() {
+        if (used > 0)
+            fwrite(buffer.data(), 1, used, file);
+        used = 0;
+    }
+
+    FILE *file;
+    vector<char> buffer;
+    size_t used = 0;
+};
+
+/**
+ * @brief Writes the color of every node as a binary file: the node count as a uint32, then one
+ * uint32 color per node from node 1 on.
+ *
+ * @param colors Indexable by node ID from 0, index 0 is skipped, each entry has a colorID.
+ * @return False if the file could not be opened.
+ */
+template <typename Colors>
+bool writeColorDump(const char *path, const Colors &colors) {
+    FILE *file = fopen(path, "wb");
+    if (file == nullptr)
+        return false;
+
+    {
+        BufferedOutput out(file);
+        uint32_t nodes = colors.size() > 0 ? colors.size() - 1 : 0;
+        out.writeBinary(nodes);
+        for (size_t node = 1; node < colors.size(); node++) out.writeBinary((uint32_t)colors[node].colorID);
+    }
+
+    return fclose(file) == 0;
+}
+
+#endif // BUFFERED_OUTPUTS
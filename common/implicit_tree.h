@@ -0,0 +1,91 @@
+#if !defined(IMPLICIT_TREES)
+#define IMPLICIT_TREES
+
+#include <algorithm>
+#include <array>
+#include <ranges>
+#include <vector>
+
+using namespace std;
+
+/**
+ * The neighbors of one node of an implicit tree, its parent first and then its children.
+ */
+template <int K>
+class ImplicitNeighbors {
+public:
+    std::array<int, K + 1> ids;
+    int count = 0;
+
+    const int *begin() const { return ids.data(); }
+    const int *end() const { return ids.data() + count; }
+};
+
+/**
+ * Levels of an implicit tree, level d holds the node IDs [starts[d], starts[d + 1]).
+ */
+class ImplicitLevels {
+public:
+    vector<int> starts;
+
+    int size() const {
+        return (int)starts.size() - 1;
+    }
+
+    auto operator[](int level) const {
+        return std::views::iota(starts[level], starts[level + 1]);
+    }
+};
+
+/**
+ * A complete k-ary tree on nodes 1 .. n numbered in level order, left to right, the
+ * way createTreeFromVector links them. Node v has parent (v - 2) / k + 1 and children
+ * k * (v - 1) + 2 .. k * (v - 1) + k + 1, so nothing but the level boundaries is stored
+ * and a node's neighbors are computed in O(k).
+ */
+template <int K>
+class ImplicitKaryTree {
+    static_assert(K >= 2, "a k-ary tree needs at least two children per node");
+
+public:
+    int maxNodes;
+    ImplicitLevels levels;
+
+    ImplicitKaryTree(int n) {
+        maxNodes = n;
+
+        long long levelSize = 1;
+        levels.starts.push_back(1);
+        for (long long start = 1; start <= n; levelSize *= K) {
+            start += levelSize;
+            levels.starts.push_back((int)std::min<long long>(start, (long long)n + 1));
+        }
+    }
+
+    /**
+     * The number of nodes of a complete k-ary tree with the given number of full levels.
+     */
+    static long long nodesInLevels(int levelCount) {
+        long long nodes = 0, levelSize = 1;
+        for (int i = 0; i < levelCount; i++, levelSize *= K) nodes += levelSize;
+        return nodes;
+    }
+
+    int parent(int node) const {
+        return node == 1 ? 0 : (node - 2) / K + 1;
+    }
+
+    ImplicitNeighbors<K> neighbors(int node) const {
+        ImplicitNeighbors<K> adjacent;
+        if (node != 1)
+            adjacent.ids[adjacent.count++] = parent(node);
+
+        long long firstChild = (long long)K * (node - 1) + 2;
+        for (long long child = firstChild; child < firstChild + K and child <= maxNodes; child++)
+            adjacent.ids[adjacent.count++] = (int)child;
+
+        return adjacent;
+    }
+};
+
+#endif // IMPLICIT_TREES
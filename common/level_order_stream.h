@@ -0,0 +1,139 @@
+#if !defined(LEVEL_ORDER_STREAMS)
+#define LEVEL_ORDER_STREAMS
+
+#include <algorithm>
+#include <span>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+/**
+ * Levels of a tree stored in level order, level d is ids[starts[d] .. starts[d + 1]).
+ */
+class StreamedLevels {
+public:
+    const vector<int> *ids = nullptr;
+    vector<int> starts;
+
+    int size() const {
+        return (int)starts.size() - 1;
+    }
+
+    span<const int> operator[](int level) const {
+        return span<const int>(ids->data() + starts[level], starts[level + 1] - starts[level]);
+    }
+};
+
+/**
+ * @brief Node IDs read from a level-order stream.
+ *
+ * IDs numbered 1 .. n in order, the numbering ImplicitKaryTree computes on the fly, are only
+ * counted. The IDs are stored from the first one out of that order on, so a numbered tree
+ * never holds them in memory.
+ */
+struct LevelOrderIDs {
+    int count = 0;
+    vector<int> ids;  // empty while the stream is numbered 1 .. count
+
+    bool isLevelOrderNumbered() const {
+        return ids.empty();
+    }
+};
+
+/**
+ * Reads node IDs until the input ends or holds something else.
+ * @param input An istream or a MappedInput.
+ */
+template <typename Input>
+LevelOrderIDs readLevelOrderIDs(Input &input) {
+    LevelOrderIDs stream;
+    for (int id; input >> id; stream.count++) {
+        if (stream.ids.empty()) {
+            if (id == stream.count + 1)
+                continue;
+
+            for (int numbered = 1; numbered <= stream.count; numbered++) stream.ids.push_back(numbered);
+        }
+        stream.ids.push_back(id);
+    }
+    return stream;
+}
+
+/**
+ * @brief A complete k-ary tree given by its level-order node IDs, the format createTreeFromVector takes.
+ *
+ * The i-th ID (from 0) is the parent of the IDs at K * i + 1 .. K * i + K, so the adjacency is
+ * written straight into CSR form: the neighbors of node v are adjacent[offsets[v] .. offsets[v + 1]),
+ * its parent first. No Tree node or per-node vector is built. IDs outside [1, maxNodeID] or
+ * repeated make the tree test false and leave it empty.
+ */
+template <int K>
+class LevelOrderKaryTree {
+    static_assert(K >= 2, "a k-ary tree needs at least two children per node");
+
+public:
+    int maxNodeID;
+    vector<int> ids;  // root first
+    StreamedLevels levels;
+
+    vector<int> offsets;  // maxNodeID + 2 entries
+    vector<int> adjacent;
+
+    LevelOrderKaryTree(vector<int> levelOrderIDs, int maxNodeID) : maxNodeID(maxNodeID), ids(std::move(levelOrderIDs)) {
+        int n = ids.size();
+        levels.ids = &ids;
+
+        if (not validIDs())
+            return;
+
+        levels.starts.push_back(0);
+        for (long long start = 0, levelSize = 1; start < n; levelSize *= K) {
+            start += levelSize;
+            levels.starts.push_back((int)std::min<long long>(start, n));
+        }
+
+        // the degree of a position follows from n alone, so one counting pass sizes the CSR
+        offsets.assign(maxNodeID + 2, 0);
+        for (int i = 0; i < n; i++) offsets[ids[i] + 1] = (i != 0) + childCount(i);
+        for (int v = 0; v <= maxNodeID; v++) offsets[v + 1] += offsets[v];
+
+        adjacent.resize(offsets[maxNodeID + 1]);
+        for (int i = 0; i < n; i++) {
+            int next = offsets[ids[i]];
+            if (i != 0)
+                adjacent[next++] = ids[(i - 1) / K];
+
+            for (int child = K * i + 1; child < K * i + 1 + childCount(i); child++) adjacent[next++] = ids[child];
+        }
+    }
+
+    explicit operator bool() const {
+        return not offsets.empty();
+    }
+
+    span<const int> neighbors(int node) const {
+        return span<const int>(adjacent.data() + offsets[node], offsets[node + 1] - offsets[node]);
+    }
+
+private:
+    bool validIDs() const {
+        if (maxNodeID < 0)
+            return false;
+
+        vector<bool> seen(maxNodeID + 1, false);
+        for (int id : ids) {
+            if (id < 1 or id > maxNodeID or seen[id])
+                return false;
+            seen[id] = true;
+        }
+        return true;
+    }
+
+    int childCount(int position) const {
+        long long firstChild = (long long)K * position + 1;
+        return (int)std::clamp<long long>((long long)ids.size() - firstChild, 0, K);
+    }
+};
+
+#endif // LEVEL_ORDER_STREAMS
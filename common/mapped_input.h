@@ -0,0 +1,135 @@
+#if !defined(MAPPED_INPUTS)
+#define MAPPED_INPUTS
+
+#include <cstring>
+#include <fcntl.h>
+#include <limits>
+#include <string_view>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <type_traits>
+#include <unistd.h>
+#include <vector>
+
+using namespace std;
+
+/**
+ * @class MappedInput
+ * @brief Reads whitespace separated integers from a file mapped into memory, a drop-in for cin >>.
+ *
+ * The file is mapped once and the integers are parsed in place by a hand-written scanner, so
+ * there is no line length limit, no copy into line buffers and no locale or stream state per
+ * number. A failed read (end of file, a token that is not a number, a number out of the range of
+ * the value or a negative one for an unsigned value) sets the value to 0 and makes the input test
+ * false, as an istream sets failbit.
+ */
+class MappedInput {
+public:
+    explicit MappedInput(const char *path) {
+        int fd = open(path, O_RDONLY);
+        if (fd < 0) {
+            failed = true;
+            return;
+        }
+
+        struct stat info;
+        if (fstat(fd, &info) == 0 and info.st_size > 0) {
+            void *mapped = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (mapped != MAP_FAILED) {
+                mapping = mapped;
+                mappedLength = info.st_size;
+                madvise(mapping, mappedLength, MADV_SEQUENTIAL);
+                cursor = (const char *)mapping;
+                end = cursor + mappedLength;
+            }
+        }
+
+        // pipes and other files that cannot be mapped are read whole
+        if (mapping == nullptr) {
+            char chunk[1 << 16];
+            for (ssize_t count; (count = read(fd, chunk, sizeof(chunk))) > 0;)
+                buffer.insert(buffer.end(), chunk, chunk + count);
+            cursor = buffer.data();
+            end = cursor + buffer.size();
+        }
+
+        close(fd);
+    }
+
+    MappedInput(const MappedInput &) = delete;
+    MappedInput &operator=(const MappedInput &) = delete;
+
+    ~MappedInput() {
+        if (mapping != nullptr)
+            munmap(mapping, mappedLength);
+    }
+
+    template <typename Integer>
+        requires std::is_integral_v<Integer>
+    MappedInput &operator>>(Integer &value) {
+        while (cursor != end and isSpace(*cursor)) cursor++;
+
+        bool negative = cursor != end and *cursor == '-';
+        const char *digits = cursor + (cursor != end and (*cursor == '-' or *cursor == '+'));
+        if (failed or digits == end or not isDigit(*digits) or (negative and std::is_unsigned_v<Integer>))
+            return fail(value);
+
+        // a negative number is accumulated downwards, so the most negative value fits as well
+        Integer parsed = 0;
+        for (cursor = digits; cursor != end and isDigit(*cursor); cursor++) {
+            Integer digit = *cursor - '0';
+            if (negative ? parsed < (numeric_limits<Integer>::min() + digit) / 10
+                         : parsed > (numeric_limits<Integer>::max() - digit) / 10)
+                return fail(value);
+
+            parsed = negative ? parsed * 10 - digit : parsed * 10 + digit;
+        }
+
+        value = parsed;
+        return *this;
+    }
+
+    explicit operator bool() const {
+        return not failed;
+    }
+
+    /**
+     * Skips the word if it is the next token, true if it was.
+     */
+    bool consume(string_view word) {
+        while (cursor != end and isSpace(*cursor)) cursor++;
+
+        size_t left = end - cursor;
+        if (left < word.size() or memcmp(cursor, word.data(), word.size()) != 0 or
+            (left > word.size() and not isSpace(cursor[word.size()])))
+            return false;
+
+        cursor += word.size();
+        return true;
+    }
+
+private:
+    template <typename Integer>
+    MappedInput &fail(Integer &value) {
+        failed = true;
+        value = 0;
+        return *this;
+    }
+
+    static bool isSpace(char c) {
+        return c == ' ' or c == '\n' or c == '\r' or c == '\t' or c == '\v' or c == '\f';
+    }
+
+    static bool isDigit(char c) {
+        return (unsigned char)(c - '0') < 10;
+    }
+
+    void *mapping = nullptr;
+    size_t mappedLength = 0;
+    vector<char> buffer;  // the file contents when it cannot be mapped
+
+    const char *cursor = nullptr, *end = nullptr;
+    bool failed = false;
+};
+
+#endif // MAPPED_INPUTS
@@ -0,0 +1,101 @@
+#if !defined(TREE_ARENAS)
+#define TREE_ARENAS
+
+#include <algorithm>
+#include <vector>
+
+using namespace std;
+
+/**
+ * Owns the nodes of trees built with create. Nodes are placed one after another in creation
+ * order, which is BFS order for createTreeFromVector, and all of them are freed in one step
+ * when the arena is released or goes out of scope instead of being leaked node by node.
+ *
+ * A Node is built from its data and lists the addresses of its child pointers with children(),
+ * so the same arena serves binary and 3-ary trees.
+ */
+template <typename Node>
+class TreeArena {
+public:
+    TreeArena() = default;
+    TreeArena(const TreeArena &) = delete;
+    TreeArena &operator=(const TreeArena &) = delete;
+
+    /**
+     * Makes room for count more nodes in one block, so the next count nodes are contiguous.
+     */
+    void reserve(size_t count) {
+        if (blocks.empty() or blocks.back().capacity() - blocks.back().size() < count) {
+            blocks.emplace_back();
+            blocks.back().reserve(count);
+        }
+    }
+
+    Node *create(int data) {
+        // a full block is never grown, that would move its nodes
+        if (blocks.empty() or blocks.back().size() == blocks.back().capacity())
+            reserve(std::max<size_t>(MIN_BLOCK_SIZE, nodeCount));
+
+        blocks.back().emplace_back(data);
+        nodeCount++;
+        return &blocks.back().back();
+    }
+
+    /**
+     * Moves the nodes reachable from root into one block in BFS order and frees the rest,
+     * e.g. the subtrees cut off by pruning.
+     * @return The new root, pointers to the old nodes are invalid afterwards.
+     */
+    Node *compact(Node *root) {
+        if (root == nullptr) {
+            release();
+            return nullptr;
+        }
+
+        vector<Node *> order = {root};
+        for (size_t i = 0; i < order.size(); i++) {
+            for (Node **child : order[i]->children())
+                if (*child)
+                    order.push_back(*child);
+        }
+
+        vector<Node> packed;
+        packed.reserve(order.size());
+        for (Node *node : order) packed.emplace_back(node->data);
+
+        // the children of node i follow the children of every node before it
+        size_t next = 1;
+        for (size_t i = 0; i < order.size(); i++) {
+            auto from = order[i]->children();
+            auto to = packed[i].children();
+            for (size_t slot = 0; slot < from.size(); slot++)
+                if (*from[slot])
+                    *to[slot] = &packed[next++];
+        }
+
+        blocks.clear();
+        blocks.push_back(std::move(packed));
+        nodeCount = order.size();
+        return blocks.back().data();
+    }
+
+    /**
+     * Frees every node at once, pointers to them are invalid afterwards.
+     */
+    void release() {
+        blocks = vector<vector<Node>>();
+        nodeCount = 0;
+    }
+
+    size_t size() const {
+        return nodeCount;
+    }
+
+private:
+    static constexpr size_t MIN_BLOCK_SIZE = 64;
+
+    vector<vector<Node>> blocks;  // moving a block keeps its buffer, so node pointers stay valid
+    size_t nodeCount = 0;
+};
+
+#endif // TREE_ARENAS
@@ -0,0 +1,66 @@
+#include <climits>
+#include <cstdlib>
+#include <iostream>
+#include <string.h>
+
+#include "../common/buffered_output.h"
+using namespace std;
+
+// children per node when no arity is given on the command line
+#define DEFAULT_ARITY 3
+
+void fileIO() {
+    freopen("input.txt", "r", stdin);
+    freopen("output.txt", "w", stdout);
+}
+
+/**
+ * Usage: ./main [arity] [implicit]
+ *
+ * Reads the number of levels from input.txt and writes the complete tree of that arity to
+ * output.txt, for BinaryTrees with arity 2 and ThreeAryTrees with arity 3. By default every
+ * level is written as its node IDs, the last line being the largest ID. With "implicit" only
+ * the "levels maxNodeID implicit arity" header the coloring programs read is written: the IDs
+ * are 1 .. maxNodeID in level order, so a program of that arity expands them itself, e.g.
+ *
+ *   ./main 3 implicit && cp output.txt ../ThreeAryTrees/input.txt
+ */
+int main(int argc, char *argv[]) {
+    long long arity = argc > 1 ? atoll(argv[1]) : DEFAULT_ARITY;
+    bool implicit = argc > 2 and strcmp(argv[2], "implicit") == 0;
+    if (arity < 2 or arity > INT_MAX) {
+        cerr << "arity must be between 2 and " << INT_MAX << endl;
+        return 1;
+    }
+
+    fileIO();
+    unsigned long long int l; cin >> l;
+
+    // exact level sizes, the node IDs must fit an int for the coloring program
+    long long nodes = 0;
+    for (long long i = 0, levelSize = 1; i < (long long)l; i++, levelSize *= arity) {
+        nodes += levelSize;
+        if (nodes > INT_MAX or (i + 1 < (long long)l and levelSize > INT_MAX / arity)) {
+            cerr << l << " levels of arity " << arity << " have more than " << INT_MAX << " nodes" << endl;
+            return 1;
+        }
+    }
+
+    // every ID goes through one buffer, written out in a few large chunks at the end
+    BufferedOutput out;
+
+    if (implicit) {
+        out << l << ' ' << nodes << "\nimplicit " << arity << '\n';
+        return 0;
+    }
+
+    out << l << '\n';
+
+    long long id = 1;
+    for (long long levelSize = 1; id <= nodes; levelSize *= arity) {
+        for (long long last = id + levelSize; id < last; id++) out << id << ' ';
+        out << '\n';
+    }
+
+    out << id - 1;
+}